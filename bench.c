@@ -0,0 +1,224 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "oslabs.h"
+
+/*Benchmarks the page replacement functions on synthetic reference strings. For every table size from
+10 pages up to --max-pages (by powers of ten) and every workload, it prints the faults and the
+ns/reference of count_page_faults_* and of process_page_access_* called once per reference. The
+scan-based FIFO, LRU and LFU are also run on a structure-of-arrays PTE_TABLE, once with the scalar
+victim search and once with the widest SIMD kernel the processor has.
+
+    vm_bench [--max-pages N] [--refs N] [--frames-ratio R] [--seed N]
+
+The process_page_access_* functions find each victim by scanning the page table, so on large tables
+they only get as many references as keep the scan work near SCAN_BUDGET entries.*/
+
+#define WORKLOAD_UNIFORM 0
+#define WORKLOAD_ZIPF 1
+#define WORKLOAD_LOOP 2
+#define WORKLOAD_PHASE 3
+#define WORKLOAD_CNT 4
+#define ZIPF_ALPHA 0.99
+#define PHASE_CNT 8
+#define SCAN_BUDGET 200000000LL
+#define COUNT_CNT 8
+#define PROCESS_CNT 4
+#define SOA_CNT 3
+
+static const char *workload_names[WORKLOAD_CNT] = { "uniform", "zipf", "loop", "phase" };
+
+static unsigned long long rng_state = XORSHIFT64_SEED;
+
+static double rng_unit(void)
+{
+    return (double)(xorshift64(&rng_state) >> 11) / 9007199254740992.0; //53 random bits in [0, 1)
+}
+
+static int scatter(long long page, int table_cnt)
+{
+    //spreads hot low-numbered pages over the table so they are not also neighbours in memory
+    return (int)((page * 2654435761LL) % table_cnt);
+}
+
+static int zipf_page(int table_cnt)
+{
+    /*Inverse of the continuous power-law CDF over [1, table_cnt + 1), which tracks a discrete Zipf
+distribution closely and needs no table of probabilities.*/
+    double exponent = 1.0 - ZIPF_ALPHA;
+    double top = pow((double)table_cnt + 1.0, exponent);
+    double x = pow((top - 1.0) * rng_unit() + 1.0, 1.0 / exponent);
+    long long rank = (long long)x - 1;
+
+    if(rank >= table_cnt){
+        rank = table_cnt - 1;
+    }
+    return scatter(rank, table_cnt);
+}
+
+static void make_workload(int workload, int reference_string[], int reference_cnt, int table_cnt, int frame_cnt)
+{
+    int loop_cnt = MIN(table_cnt, frame_cnt + frame_cnt / 2 + 1); //just too large to fit, the worst case for LRU
+    int phase_len = reference_cnt / PHASE_CNT + 1;
+    int set_cnt = MAX(1, MIN(table_cnt, frame_cnt / 2 + 1));
+    int set_base = 0;
+
+    for(int i = 0; i < reference_cnt; i++){
+        switch(workload){
+        case WORKLOAD_UNIFORM:
+            reference_string[i] = (int)(xorshift64(&rng_state) % (unsigned long long)table_cnt);
+            break;
+        case WORKLOAD_ZIPF:
+            reference_string[i] = zipf_page(table_cnt);
+            break;
+        case WORKLOAD_LOOP:
+            reference_string[i] = i % loop_cnt;
+            break;
+        default:
+            if(i % phase_len == 0){
+                set_base = (int)(xorshift64(&rng_state) % (unsigned long long)table_cnt); //locality moves to a new set of pages
+            }
+            reference_string[i] = (set_base + (int)(xorshift64(&rng_state) % (unsigned long long)set_cnt)) % table_cnt;
+            break;
+        }
+    }
+}
+
+static void reset_table(struct PTE page_table[], int table_cnt, int frame_pool[], int frame_cnt)
+{
+    for(int i = 0; i < table_cnt; i++){
+        page_table[i].is_valid = 0;
+        page_table[i].frame_number = -1;
+        page_table[i].arrival_timestamp = -1;
+        page_table[i].last_access_timestamp = -1;
+        page_table[i].reference_count = -1;
+        page_table[i].reference_bit = 0;
+    }
+    for(int i = 0; i < frame_cnt; i++){
+        frame_pool[i] = i;
+    }
+}
+
+static void report(const char *workload, int table_cnt, int frame_cnt, const char *function, int reference_cnt, long long faults, long long elapsed)
+{
+    printf("%-8s %9d %9d %-26s %9d %9lld %10.1f\n", workload, table_cnt, frame_cnt, function, reference_cnt, faults,
+        reference_cnt > 0 ? (double)elapsed / reference_cnt : 0.0);
+    fflush(stdout);
+}
+
+static void bench_size(int table_cnt, int reference_cnt, double frames_ratio, int reference_string[], struct PTE page_table[], int frame_pool[])
+{
+    static const char *count_names[COUNT_CNT] = { "count_page_faults_fifo", "count_page_faults_lru", "count_page_faults_lfu",
+        "count_page_faults_clock", "count_page_faults_clockpro", "count_page_faults_arc", "count_page_faults_2q",
+        "count_page_faults_opt" };
+    static const char *process_names[PROCESS_CNT] = { "process_page_access_fifo", "process_page_access_lru", "process_page_access_lfu",
+        "process_page_access_clock" };
+    int (*count_functions[COUNT_CNT])(struct PTE[], int, int[], int, int[], int) = { count_page_faults_fifo, count_page_faults_lru,
+        count_page_faults_lfu, count_page_faults_clock, count_page_faults_clockpro, count_page_faults_arc, count_page_faults_2q,
+        count_page_faults_opt };
+    int (*process_functions[PROCESS_CNT])(struct PTE[], int *, int, int[], int *, int) = { process_page_access_fifo, process_page_access_lru,
+        process_page_access_lfu, process_page_access_clock };
+    static const char *soa_names[SOA_CNT][3] = { { "soa_fifo_scalar", "soa_fifo_sse41", "soa_fifo_avx2" },
+        { "soa_lru_scalar", "soa_lru_sse41", "soa_lru_avx2" }, { "soa_lfu_scalar", "soa_lfu_sse41", "soa_lfu_avx2" } };
+    int frame_cnt = MAX(1, (int)(table_cnt * frames_ratio));
+    int process_cnt = (int)MIN((long long)reference_cnt, MAX(1000LL, SCAN_BUDGET / table_cnt));
+    struct PTE_TABLE *pt = pte_table_create(table_cnt);
+    int best_kernel = pte_table_best_kernel();
+
+    for(int workload = 0; workload < WORKLOAD_CNT; workload++){
+        make_workload(workload, reference_string, reference_cnt, table_cnt, frame_cnt);
+        for(int policy = 0; policy < COUNT_CNT; policy++){
+            long long start;
+            int faults;
+
+            reset_table(page_table, table_cnt, frame_pool, frame_cnt);
+            start = monotonic_ns();
+            faults = count_functions[policy](page_table, table_cnt, reference_string, reference_cnt, frame_pool, frame_cnt);
+            report(workload_names[workload], table_cnt, frame_cnt, count_names[policy], reference_cnt, faults, monotonic_ns() - start);
+        }
+        for(int policy = 0; policy < PROCESS_CNT; policy++){
+            int free_cnt = frame_cnt;
+            int table = table_cnt;
+            long long faults = 0;
+            long long start;
+
+            reset_table(page_table, table_cnt, frame_pool, frame_cnt);
+            start = monotonic_ns();
+            for(int i = 0; i < process_cnt; i++){
+                faults += page_table[reference_string[i]].is_valid == 0;
+                process_functions[policy](page_table, &table, reference_string[i], frame_pool, &free_cnt, i + 1);
+            }
+            report(workload_names[workload], table_cnt, frame_cnt, process_names[policy], process_cnt, faults, monotonic_ns() - start);
+        }
+        for(int policy = 0; policy < SOA_CNT && pt != NULL; policy++){
+            for(int kernel = PTE_KERNEL_SCALAR; kernel <= best_kernel; kernel = kernel == PTE_KERNEL_SCALAR ? best_kernel : kernel + 1){
+                int free_cnt = frame_cnt;
+                long long faults = 0;
+                long long start;
+
+                reset_table(page_table, table_cnt, frame_pool, frame_cnt);
+                pte_table_load(pt, page_table);
+                pt->kernel = kernel;
+                start = monotonic_ns();
+                for(int i = 0; i < process_cnt; i++){
+                    faults += pt->is_valid[reference_string[i]] == 0;
+                    process_page_access_soa(pt, policy, reference_string[i], frame_pool, &free_cnt, i + 1);
+                }
+                report(workload_names[workload], table_cnt, frame_cnt, soa_names[policy][kernel], process_cnt, faults, monotonic_ns() - start);
+                if(kernel == best_kernel){
+                    break;
+                }
+            }
+        }
+    }
+    pte_table_destroy(pt);
+}
+
+int main(int argc, char *argv[])
+{
+    int max_pages = 1000000;
+    int reference_cnt = 1000000;
+    double frames_ratio = 0.25;
+    int *reference_string;
+    struct PTE *page_table;
+    int *frame_pool;
+
+    for(int i = 1; i < argc; i++){
+        if(strcmp(argv[i], "--max-pages") == 0 && i + 1 < argc){
+            max_pages = atoi(argv[++i]);
+        }
+        else if(strcmp(argv[i], "--refs") == 0 && i + 1 < argc){
+            reference_cnt = atoi(argv[++i]);
+        }
+        else if(strcmp(argv[i], "--frames-ratio") == 0 && i + 1 < argc){
+            frames_ratio = atof(argv[++i]);
+        }
+        else if(strcmp(argv[i], "--seed") == 0 && i + 1 < argc){
+            rng_state = strtoull(argv[++i], NULL, 10) | 1;
+        }
+        else {
+            fprintf(stderr, "usage: %s [--max-pages N] [--refs N] [--frames-ratio R] [--seed N]\n", argv[0]);
+            return 2;
+        }
+    }
+    if(max_pages < 10 || reference_cnt <= 0 || frames_ratio <= 0.0 || frames_ratio > 1.0){
+        fprintf(stderr, "%s: --max-pages must be at least 10, --refs positive and --frames-ratio in (0, 1]\n", argv[0]);
+        return 2;
+    }
+    reference_string = malloc((size_t)reference_cnt * sizeof(int));
+    page_table = malloc((size_t)max_pages * sizeof(struct PTE));
+    frame_pool = malloc((size_t)max_pages * sizeof(int));
+    if(reference_string == NULL || page_table == NULL || frame_pool == NULL){
+        fprintf(stderr, "%s: out of memory\n", argv[0]);
+        return 1;
+    }
+    printf("%-8s %9s %9s %-26s %9s %9s %10s\n", "workload", "pages", "frames", "function", "refs", "faults", "ns/ref");
+    for(long long table_cnt = 10; table_cnt <= max_pages; table_cnt *= 10){
+        bench_size((int)table_cnt, reference_cnt, frames_ratio, reference_string, page_table, frame_pool);
+    }
+    free(reference_string);
+    free(page_table);
+    free(frame_pool);
+    return 0;
+}
@@ -0,0 +1,569 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "oslabs.h"
+
+/*Reference-bit approximations of LRU. A hit only sets the page's reference_bit, so it costs a store
+instead of the list or timestamp update true LRU needs, and all the work happens on faults.
+
+CLOCK keeps the pages in memory on an LRU_LIST in the order they reached the hand, with the head as the
+hand. A page under the hand with its reference_bit set gets a second chance: the bit is cleared and the
+page moves to the tail. The first page found with a clear bit is replaced.
+
+CLOCK-Pro (Jiang, Chen and Zhang, USENIX 2005) keeps hot and cold pages in memory, plus non-resident
+"test" pages that were recently evicted while cold, all on one ring swept by three hands. A cold page
+that is referenced again during its test period, even after it has left memory, is promoted to hot.
+The number of frames given to cold pages (mem_cold) adapts: it grows when a test page is referenced
+and shrinks when a test period runs out. It never takes the last frame from the hot pages, or a loop
+just larger than memory would keep every page cold and fault on every reference, as under LRU.*/
+
+#define CLOCK_PRO_NONE 0
+#define CLOCK_PRO_COLD 1
+#define CLOCK_PRO_HOT 2
+#define CLOCK_PRO_TEST 3
+
+static int page_before(struct LRU_LIST *list, int a, int b)
+{
+    //page order for second-chance ties, by rank when the list has one
+    return list->rank != NULL ? list->rank[a] < list->rank[b] : a < b;
+}
+
+static int merge_by_page(struct LRU_LIST *list, int first, int second)
+{
+    //merges two chains linked through next, each in increasing page order
+    int *next = list->next;
+    int head = -1;
+    int *link = &head;
+
+    while(first != -1 && second != -1){
+        if(page_before(list, first, second)){
+            *link = first;
+            link = &next[first];
+            first = next[first];
+        }
+        else {
+            *link = second;
+            link = &next[second];
+            second = next[second];
+        }
+    }
+    *link = first != -1 ? first : second;
+    return head;
+}
+
+static int sort_by_page(struct LRU_LIST *list, int head, int cnt)
+{
+    //merge sorts the chain of cnt pages starting at head and returns its new head
+    int middle = head;
+    int second;
+
+    if(cnt <= 1){
+        list->next[head] = -1;
+        return head;
+    }
+    for(int i = 1; i < cnt / 2; i++){
+        middle = list->next[middle];
+    }
+    second = list->next[middle];
+    list->next[middle] = -1;
+    return merge_by_page(list, sort_by_page(list, head, cnt / 2), sort_by_page(list, second, cnt - cnt / 2));
+}
+
+static void sort_tail(struct LRU_LIST *list, int cnt)
+{
+    //puts the last cnt pages of the list in page order
+    int first = list->tail;
+    int before;
+    int page;
+
+    for(int i = 1; i < cnt; i++){
+        first = list->prev[first];
+    }
+    before = list->prev[first];
+    page = sort_by_page(list, first, cnt);
+    if(before != -1){
+        list->next[before] = page;
+    }
+    else {
+        list->head = page;
+    }
+    for(; page != -1; page = list->next[page]){
+        list->prev[page] = before;
+        before = page;
+    }
+    list->tail = before;
+}
+
+static void clock_list_push(struct LRU_LIST *list, struct PTE page_table[], int page_number)
+{
+    /*Puts a page that just arrived behind the hand, after the pages that arrived at the same time with a
+lower page number. Only pages given a second chance by this access can share its arrival_timestamp.*/
+    int after = list->tail;
+
+    while(after != -1 && page_table[after].arrival_timestamp == page_table[page_number].arrival_timestamp
+        && page_before(list, page_number, after)){
+        after = list->prev[after];
+    }
+    if(after == list->tail){
+        lru_list_push(list, page_number);
+        return;
+    }
+    list->prev[page_number] = after;
+    list->next[page_number] = after != -1 ? list->next[after] : list->head;
+    list->prev[list->next[page_number]] = page_number;
+    if(after != -1){
+        list->next[after] = page_number;
+    }
+    else {
+        list->head = page_number;
+    }
+    list->size += 1;
+}
+
+int clock_list_victim(struct LRU_LIST *list, struct PTE page_table[], int current_timestamp)
+{
+    /*Turns the hand until the page under it has a clear reference_bit and returns that page without
+removing it, or -1 if nothing is in memory. A page that gets a second chance goes to the tail with
+current_timestamp as its arrival_timestamp. The pages that share it are then put in page-number order,
+the order a scan of the page table breaks the tie in, so the clock order is always the order of
+arrival_timestamp and then page number, or list->rank when it is set. Calling this again before the
+victim is replaced returns the same page.*/
+    int victim = list->head;
+    int moved = 0;
+
+    while(victim != -1 && page_table[victim].reference_bit != 0){
+        page_table[victim].reference_bit = 0; //second chance
+        page_table[victim].arrival_timestamp = current_timestamp;
+        lru_list_unlink(list, victim);
+        lru_list_push(list, victim);
+        victim = list->head;
+        moved += 1;
+    }
+    if(moved > 1){
+        sort_tail(list, moved);
+        victim = list->head; //changes only if every page got a second chance
+    }
+    return victim;
+}
+
+int clock_list_access(struct LRU_LIST *list,
+struct PTE page_table[],
+int page_number,
+int frame_pool[],
+int *frame_cnt,
+int current_timestamp)
+{
+    /*Same contract as process_page_access_clock for a list set up with fifo_list_init. A hit sets
+the reference_bit and leaves the page where it is on the clock. A new page goes behind the hand with
+its reference_bit set. Returns -1 if there is neither a free frame nor a page in memory to replace.*/
+    struct PTE *entry = &page_table[page_number];
+    int victim;
+
+    if(entry->is_valid != 0){
+        entry->reference_count += 1; //update reference count
+        entry->last_access_timestamp = current_timestamp; //update time
+        entry->reference_bit = 1;
+        return entry->frame_number;
+    }
+    if(*frame_cnt > 0){
+        *frame_cnt -= 1; //lowers frame count
+        entry->frame_number = frame_pool[*frame_cnt];
+    }
+    else {
+        victim = clock_list_victim(list, page_table, current_timestamp);
+        if(victim == -1){
+            return -1;
+        }
+        lru_list_unlink(list, victim);
+        entry->frame_number = page_table[victim].frame_number; //replaces the page in memory
+
+        page_table[victim].frame_number = -1;
+        page_table[victim].is_valid = 0;
+        page_table[victim].arrival_timestamp = -1;
+        page_table[victim].last_access_timestamp = -1;
+        page_table[victim].reference_count = -1;
+        page_table[victim].reference_bit = 0;
+    }
+    entry->is_valid = 1;
+    entry->arrival_timestamp = current_timestamp;
+    entry->last_access_timestamp = current_timestamp;
+    entry->reference_count = 1;
+    entry->reference_bit = 1;
+    clock_list_push(list, page_table, page_number);
+    return entry->frame_number;
+}
+
+static void hot_link(struct CLOCK_PRO *cp, int page_number)
+{
+    //a page that turns hot at the head of the ring is the last one the hot hand reaches
+    if(cp->hot_cursor == -1){
+        cp->hot_next[page_number] = page_number;
+        cp->hot_prev[page_number] = page_number;
+        cp->hot_cursor = page_number;
+        return;
+    }
+    cp->hot_prev[page_number] = cp->hot_prev[cp->hot_cursor];
+    cp->hot_next[page_number] = cp->hot_cursor;
+    cp->hot_next[cp->hot_prev[cp->hot_cursor]] = page_number;
+    cp->hot_prev[cp->hot_cursor] = page_number;
+}
+
+static void hot_unlink(struct CLOCK_PRO *cp, int page_number)
+{
+    int next = cp->hot_next[page_number];
+
+    if(next == page_number){
+        cp->hot_cursor = -1;
+        return;
+    }
+    cp->hot_next[cp->hot_prev[page_number]] = next;
+    cp->hot_prev[next] = cp->hot_prev[page_number];
+    if(cp->hot_cursor == page_number){
+        cp->hot_cursor = next;
+    }
+}
+
+static void ring_add(struct CLOCK_PRO *cp, int page_number, int type)
+{
+    //links the page in just behind the hot hand, which is the head of the ring
+    cp->type[page_number] = type;
+    if(type == CLOCK_PRO_HOT){
+        hot_link(cp, page_number);
+    }
+    if(cp->hand_hot == -1){
+        cp->next[page_number] = page_number;
+        cp->prev[page_number] = page_number;
+        cp->hand_hot = page_number;
+        cp->hand_cold = page_number;
+        cp->hand_test = page_number;
+        return;
+    }
+    cp->prev[page_number] = cp->prev[cp->hand_hot];
+    cp->next[page_number] = cp->hand_hot;
+    cp->next[cp->prev[cp->hand_hot]] = page_number;
+    cp->prev[cp->hand_hot] = page_number;
+    if(cp->hand_cold == cp->hand_hot){
+        cp->hand_cold = page_number;
+    }
+}
+
+static void ring_remove(struct CLOCK_PRO *cp, int page_number)
+{
+    /*The cold and test hands on the page step back so their next move lands where the page was. The
+hot hand steps forward instead, it only ever rests just after the last hot page it looked at.*/
+    int prev = cp->prev[page_number];
+
+    if(prev == page_number){
+        cp->hand_hot = -1;
+        cp->hand_cold = -1;
+        cp->hand_test = -1;
+    }
+    else {
+        if(cp->hand_hot == page_number){
+            cp->hand_hot = cp->next[page_number];
+        }
+        if(cp->hand_cold == page_number){
+            cp->hand_cold = prev;
+        }
+        if(cp->hand_test == page_number){
+            cp->hand_test = prev;
+        }
+        cp->next[prev] = cp->next[page_number];
+        cp->prev[cp->next[page_number]] = prev;
+    }
+    if(cp->type[page_number] == CLOCK_PRO_HOT){
+        hot_unlink(cp, page_number);
+    }
+    cp->type[page_number] = CLOCK_PRO_NONE;
+}
+
+static void run_hand_test(struct CLOCK_PRO *cp)
+{
+    //ends the test period of the next test page, so cold pages get fewer frames
+    int page = cp->hand_test;
+
+    if(page == -1){
+        return;
+    }
+    if(cp->type[page] == CLOCK_PRO_TEST){
+        ring_remove(cp, page);
+        cp->count_test -= 1;
+        if(cp->mem_cold > 1){
+            cp->mem_cold -= 1;
+        }
+    }
+    if(cp->hand_test != -1){
+        cp->hand_test = cp->next[cp->hand_test];
+    }
+}
+
+static void run_hand_hot(struct CLOCK_PRO *cp, struct PTE page_table[])
+{
+    /*Moves the hot hand to the next hot page and demotes it if it has not been referenced since the
+hand last passed it. The hand has nothing to do at cold and test pages, so it jumps over them along
+the hot pages' own links instead of stepping through the ring.*/
+    int page = cp->hot_cursor;
+
+    if(page == -1){
+        return;
+    }
+    if(page_table[page].reference_bit != 0){
+        page_table[page].reference_bit = 0;
+        cp->hot_cursor = cp->hot_next[page];
+    }
+    else {
+        hot_unlink(cp, page);
+        cp->type[page] = CLOCK_PRO_COLD;
+        cp->count_hot -= 1;
+        cp->count_cold += 1;
+    }
+    cp->hand_hot = cp->next[page];
+}
+
+static void run_hand_cold(struct CLOCK_PRO *cp, struct PTE page_table[])
+{
+    /*Looks at the cold page under the hand. If it was referenced it becomes hot and moves to the head of
+the ring, otherwise it leaves memory as a test page and its frame goes on the released stack. The hands move independently and may
+pass each other, which keeps every hand move a bounded loop instead of one hand pushing the next.*/
+    int page = cp->hand_cold;
+
+    if(cp->type[page] == CLOCK_PRO_COLD){
+        if(page_table[page].reference_bit != 0){
+            page_table[page].reference_bit = 0;
+            ring_remove(cp, page);
+            ring_add(cp, page, CLOCK_PRO_HOT);
+            cp->count_cold -= 1;
+            cp->count_hot += 1;
+        }
+        else {
+            cp->type[page] = CLOCK_PRO_TEST;
+            cp->released[cp->released_cnt++] = page_table[page].frame_number;
+            page_table[page].frame_number = -1;
+            page_table[page].is_valid = 0;
+            page_table[page].arrival_timestamp = -1;
+            page_table[page].last_access_timestamp = -1;
+            page_table[page].reference_count = -1;
+            page_table[page].reference_bit = 0;
+            cp->count_cold -= 1;
+            cp->count_test += 1;
+            cp->evicted_page = page;
+            cp->evictions += 1;
+        }
+    }
+    if(cp->hand_cold != -1){
+        cp->hand_cold = cp->next[cp->hand_cold];
+    }
+    while(cp->count_test > cp->mem_max){
+        run_hand_test(cp); //may remove the page the cold hand just left
+    }
+    while(cp->mem_max - cp->mem_cold < cp->count_hot){
+        run_hand_hot(cp, page_table);
+    }
+}
+
+int clockpro_init(struct CLOCK_PRO *cp,
+int next[],
+int prev[],
+int type[],
+int hot_next[],
+int hot_prev[],
+int released[],
+struct PTE page_table[],
+int table_cnt,
+int frame_cnt)
+{
+    /*Puts every page already in memory on the ring as a cold page, in arrival order, keeping its
+reference_bit. The ring has as many frames as there are pages in memory plus frame_cnt free ones. The
+next, prev, type, hot_next, hot_prev and released arrays must hold table_cnt entries each.
+Returns 0 on success and -1 if the temporary sort buffer cannot be allocated.*/
+    struct LRU_LIST order;
+
+    if(fifo_list_init(&order, prev, next, page_table, table_cnt) != 0){
+        return -1;
+    }
+    cp->next = next;
+    cp->prev = prev;
+    cp->type = type;
+    cp->hot_next = hot_next;
+    cp->hot_prev = hot_prev;
+    cp->hot_cursor = -1;
+    cp->released = released;
+    cp->released_cnt = 0;
+    cp->hand_hot = -1;
+    cp->hand_cold = -1;
+    cp->hand_test = -1;
+    cp->count_hot = 0;
+    cp->count_cold = 0;
+    cp->count_test = 0;
+    cp->mem_max = order.size + frame_cnt;
+    cp->mem_cold = MAX(1, cp->mem_max - 1);
+    cp->evicted_page = -1;
+    cp->evictions = 0;
+    cp->test_hits = 0;
+    for(int i = 0; i < table_cnt; i++){
+        type[i] = CLOCK_PRO_NONE;
+    }
+    for(int page = order.head; page != -1; ){
+        int after = next[page]; //ring_add reuses the link arrays the order was built in
+        ring_add(cp, page, CLOCK_PRO_COLD);
+        cp->count_cold += 1;
+        page = after;
+    }
+    return 0;
+}
+
+static int clockpro_load(struct CLOCK_PRO *cp,
+struct PTE page_table[],
+int page_number,
+int frame_pool[],
+int *frame_cnt,
+int current_timestamp,
+int prefetch)
+{
+    /*Brings a page that is not in memory in. A prefetch is not a reference, so it ends the test period
+of a test page without promoting it or giving cold pages more room, and the page starts cold with a
+reference_count of 0.*/
+    struct PTE *entry = &page_table[page_number];
+    int type;
+
+    if(cp->mem_max == 0){
+        return -1;
+    }
+    type = CLOCK_PRO_COLD;
+    if(cp->type[page_number] == CLOCK_PRO_TEST){
+        if(!prefetch){
+            if(cp->mem_cold < cp->mem_max - 1){
+                cp->mem_cold += 1; //a cold page was evicted too soon, give cold pages more room
+            }
+            cp->test_hits += 1;
+            type = CLOCK_PRO_HOT;
+        }
+        cp->count_test -= 1;
+        ring_remove(cp, page_number);
+    }
+    if(*frame_cnt > 0){
+        *frame_cnt -= 1; //lowers frame count
+        entry->frame_number = frame_pool[*frame_cnt];
+    }
+    else {
+        while(cp->released_cnt == 0){
+            run_hand_cold(cp, page_table);
+        }
+        entry->frame_number = cp->released[--cp->released_cnt];
+    }
+    ring_add(cp, page_number, type);
+    if(type == CLOCK_PRO_HOT){
+        cp->count_hot += 1;
+    }
+    else {
+        cp->count_cold += 1;
+    }
+    entry->is_valid = 1;
+    entry->arrival_timestamp = current_timestamp;
+    entry->last_access_timestamp = current_timestamp;
+    entry->reference_count = prefetch ? 0 : 1;
+    entry->reference_bit = 0;
+    return entry->frame_number;
+}
+
+int clockpro_access(struct CLOCK_PRO *cp,
+struct PTE page_table[],
+int page_number,
+int frame_pool[],
+int *frame_cnt,
+int current_timestamp)
+{
+    /*Returns the frame number of the logical page, loading it if needed. A hit sets the
+reference_bit, except the first reference to a prefetched page, which only counts as its load. A page
+referenced again while it is a test page comes back hot, otherwise a loaded page starts cold with a
+clear reference_bit. cp->evicted_page is the page this access moved out of memory, or -1. Returns -1
+if the ring has no frames at all.*/
+    struct PTE *entry = &page_table[page_number];
+
+    cp->evicted_page = -1;
+    if(entry->is_valid != 0){
+        entry->reference_bit = entry->reference_count != 0;
+        entry->reference_count += 1; //update reference count
+        entry->last_access_timestamp = current_timestamp; //update time
+        return entry->frame_number;
+    }
+    return clockpro_load(cp, page_table, page_number, frame_pool, frame_cnt, current_timestamp, 0);
+}
+
+int clockpro_prefetch(struct CLOCK_PRO *cp,
+struct PTE page_table[],
+int page_number,
+int frame_pool[],
+int *frame_cnt,
+int current_timestamp)
+{
+    /*Loads the page ahead of its first reference as a cold page, replacing like a fault but without
+counting or promoting a test page. A page already in memory is left alone. Returns the frame number,
+or -1 if the ring has no frames at all.*/
+    cp->evicted_page = -1;
+    if(page_table[page_number].is_valid != 0){
+        return page_table[page_number].frame_number;
+    }
+    return clockpro_load(cp, page_table, page_number, frame_pool, frame_cnt, current_timestamp, 1);
+}
+
+int process_page_access_clock(struct PTE page_table[],
+int *table_cnt,
+int page_number,
+int frame_pool[],
+int *frame_cnt,
+int current_timestamp)
+{
+    /*Returns the frame number of the logical page, loading it if needed. The clock order is kept in
+arrival_timestamp, so when there are no free frames pages are looked at from the smallest
+arrival_timestamp up. A page with its reference_bit set has the bit cleared and arrives again at
+current_timestamp, and the first page with a clear bit is replaced. Pages that share an
+arrival_timestamp are looked at lowest page number first.*/
+    struct PAGE_CONTEXT view;
+    int frame_number;
+
+    page_context_view(&view, page_table, *table_cnt, frame_pool, *frame_cnt, POLICY_CLOCK);
+    frame_number = page_context_access(&view, page_number, current_timestamp);
+    *frame_cnt = view.frame_cnt; //a frame may have been taken from the pool
+    return frame_number;
+}
+
+int count_page_faults_clock(struct PTE page_table[],
+int table_cnt,
+int reference_string[],
+int reference_cnt,
+int frame_pool[],
+int frame_cnt)
+{
+    /*Returns the number of page faults for the reference string under CLOCK replacement, starting with
+a timestamp of 1 and incrementing it for every page access. Returns -1 if the context cannot be
+allocated or the reference string names a page outside the page table.*/
+    struct PAGE_CONTEXT *ctx = page_context_attach(page_table, table_cnt, frame_pool, frame_cnt, POLICY_CLOCK);
+    int page_fault_counter;
+
+    if(ctx == NULL){
+        return -1;
+    }
+    page_fault_counter = page_context_run(ctx, reference_string, reference_cnt);
+    page_context_destroy(ctx);
+    return page_fault_counter;
+}
+
+int count_page_faults_clockpro(struct PTE page_table[],
+int table_cnt,
+int reference_string[],
+int reference_cnt,
+int frame_pool[],
+int frame_cnt)
+{
+    /*Same as count_page_faults_clock under CLOCK-Pro replacement. CLOCK-Pro needs its ring and hands to
+persist between accesses, so unlike the other policies it has no single-access function.*/
+    struct PAGE_CONTEXT *ctx = page_context_attach(page_table, table_cnt, frame_pool, frame_cnt, POLICY_CLOCK_PRO);
+    int page_fault_counter;
+
+    if(ctx == NULL){
+        return -1;
+    }
+    page_fault_counter = page_context_run(ctx, reference_string, reference_cnt);
+    page_context_destroy(ctx);
+    return page_fault_counter;
+}
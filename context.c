@@ -0,0 +1,538 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <limits.h>
+#include <time.h>
+#include "oslabs.h"
+
+/*A PAGE_CONTEXT holds one simulation: a page table and frame pool of any size, the replacement engine
+for the chosen policy and the hit/fault counters. Everything a context owns comes out of a single
+allocation (the arena), so creating or destroying one costs one malloc or free no matter how large the
+page table is.*/
+
+size_t arena_size(size_t bytes)
+{
+    //bytes rounded up so every piece of an arena stays ARENA_ALIGN aligned
+    return (bytes + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1);
+}
+
+void *arena_take(struct ARENA *arena, size_t bytes)
+{
+    //hands out the next piece of the arena, the caller has already sized it with arena_size
+    void *piece = arena->base + arena->used;
+    arena->used += arena_size(bytes);
+    return piece;
+}
+
+long long monotonic_ns(void)
+{
+    //CLOCK_MONOTONIC in nanoseconds, for timing runs
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (long long)now.tv_sec * 1000000000LL + now.tv_nsec;
+}
+
+unsigned long long xorshift64(unsigned long long *state)
+{
+    //advances a xorshift64 generator and returns its new state, which must start nonzero
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+    return *state;
+}
+
+static struct PAGE_CONTEXT *context_alloc(int table_cnt, int pool_cnt, int owns_arrays)
+{
+    /*Lays out the context, its engine storage and (when owns_arrays is set) the page table and frame
+pool in one block. The engines share the page link arrays since a context only runs one policy at a
+time.*/
+    struct ARENA arena;
+    struct PAGE_CONTEXT *ctx;
+    size_t bytes = arena_size(sizeof(struct PAGE_CONTEXT))
+        + 6 * arena_size((size_t)table_cnt * sizeof(int));
+    int *prev;
+    int *next;
+    int *type;
+
+    if(owns_arrays){
+        bytes += arena_size((size_t)table_cnt * sizeof(struct PTE)) + arena_size((size_t)pool_cnt * sizeof(int));
+    }
+#ifdef OSLABS_INSTRUMENT
+    bytes += 2 * arena_size((size_t)table_cnt * sizeof(int));
+#endif
+    arena.base = malloc(bytes);
+    arena.used = 0;
+    if(arena.base == NULL){
+        return NULL;
+    }
+    ctx = arena_take(&arena, sizeof(struct PAGE_CONTEXT));
+    ctx->arena = arena.base;
+    ctx->table_cnt = table_cnt;
+    ctx->pool_cnt = pool_cnt;
+    ctx->has_engine = 1;
+    ctx->timestamp = 1;
+    ctx->page_hits = 0;
+    ctx->page_faults = 0;
+    ctx->evictions = 0;
+    ctx->ghost_hits = 0;
+    ctx->evicted_page = -1;
+    prev = arena_take(&arena, (size_t)table_cnt * sizeof(int));
+    next = arena_take(&arena, (size_t)table_cnt * sizeof(int));
+    ctx->list.prev = prev;
+    ctx->list.next = next;
+    ctx->lfu.heap = prev;
+    ctx->lfu.position = next;
+    ctx->lfu.size = 0;
+    type = arena_take(&arena, (size_t)table_cnt * sizeof(int));
+    ctx->clockpro.next = next;
+    ctx->clockpro.prev = prev;
+    ctx->clockpro.type = type;
+    ctx->clockpro.hot_next = arena_take(&arena, (size_t)table_cnt * sizeof(int));
+    ctx->clockpro.hot_prev = arena_take(&arena, (size_t)table_cnt * sizeof(int));
+    ctx->clockpro.released = arena_take(&arena, (size_t)table_cnt * sizeof(int));
+    ctx->arc.list = type;
+    ctx->two_queue.list = type;
+    if(owns_arrays){
+        ctx->page_table = arena_take(&arena, (size_t)table_cnt * sizeof(struct PTE));
+        ctx->frame_pool = arena_take(&arena, (size_t)pool_cnt * sizeof(int));
+    }
+    ctx->last_reference = NULL;
+    ctx->loaded_at = NULL;
+#ifdef OSLABS_INSTRUMENT
+    ctx->last_reference = arena_take(&arena, (size_t)table_cnt * sizeof(int));
+    ctx->loaded_at = arena_take(&arena, (size_t)table_cnt * sizeof(int));
+    for(int i = 0; i < table_cnt; i++){
+        ctx->last_reference[i] = -1;
+        ctx->loaded_at[i] = -1;
+    }
+#endif
+    return ctx;
+}
+
+static int context_seed(struct PAGE_CONTEXT *ctx)
+{
+    //builds the engine for ctx->policy from whatever is in the page table
+    switch(ctx->policy){
+    case POLICY_FIFO:
+    case POLICY_CLOCK:
+        return fifo_list_init(&ctx->list, ctx->list.prev, ctx->list.next, ctx->page_table, ctx->table_cnt);
+    case POLICY_LRU:
+        return lru_list_init(&ctx->list, ctx->list.prev, ctx->list.next, ctx->page_table, ctx->table_cnt);
+    case POLICY_LFU:
+        return lfu_table_init(&ctx->lfu, ctx->lfu.heap, ctx->lfu.position, ctx->page_table, ctx->table_cnt);
+    case POLICY_CLOCK_PRO:
+        return clockpro_init(&ctx->clockpro, ctx->clockpro.next, ctx->clockpro.prev, ctx->clockpro.type, ctx->clockpro.hot_next,
+            ctx->clockpro.hot_prev, ctx->clockpro.released, ctx->page_table, ctx->table_cnt, ctx->frame_cnt);
+    case POLICY_ARC:
+        return arc_init(&ctx->arc, ctx->list.prev, ctx->list.next, ctx->arc.list, ctx->page_table, ctx->table_cnt, ctx->frame_cnt);
+    case POLICY_2Q:
+        return two_queue_init(&ctx->two_queue, ctx->list.prev, ctx->list.next, ctx->two_queue.list, ctx->page_table, ctx->table_cnt,
+            ctx->frame_cnt);
+    }
+    return -1;
+}
+
+static int valid_policy(int policy)
+{
+    return policy == POLICY_FIFO || policy == POLICY_LRU || policy == POLICY_LFU
+        || policy == POLICY_CLOCK || policy == POLICY_CLOCK_PRO || policy == POLICY_ARC || policy == POLICY_2Q;
+}
+
+static int adaptive_policy(int policy)
+{
+    //policies whose engine decides what leaves memory and keeps state the page table cannot hold
+    return policy == POLICY_CLOCK_PRO || policy == POLICY_ARC || policy == POLICY_2Q;
+}
+
+struct PAGE_CONTEXT *page_context_create(int table_cnt, int pool_cnt, int policy)
+{
+    /*Creates a context with its own page table of table_cnt entries, all invalid, and a frame pool
+holding frames 0 to pool_cnt - 1. Returns NULL if the sizes or policy are invalid or the arena cannot
+be allocated.*/
+    struct PAGE_CONTEXT *ctx;
+
+    if(table_cnt <= 0 || pool_cnt < 0 || !valid_policy(policy)){
+        return NULL;
+    }
+    ctx = context_alloc(table_cnt, pool_cnt, 1);
+    if(ctx == NULL){
+        return NULL;
+    }
+    page_context_reset(ctx, policy, pool_cnt);
+    return ctx;
+}
+
+struct PAGE_CONTEXT *page_context_attach(struct PTE page_table[],
+int table_cnt,
+int frame_pool[],
+int frame_cnt,
+int policy)
+{
+    /*Creates a context that works on the caller's page table and frame pool in place. Pages already in
+memory are picked up by the engine, so the caller can continue a simulation it started elsewhere.
+Returns NULL if the sizes or policy are invalid or the arena cannot be allocated.*/
+    struct PAGE_CONTEXT *ctx;
+
+    if(table_cnt <= 0 || frame_cnt < 0 || !valid_policy(policy)){
+        return NULL;
+    }
+    ctx = context_alloc(table_cnt, frame_cnt, 0);
+    if(ctx == NULL){
+        return NULL;
+    }
+    ctx->policy = policy;
+    ctx->page_table = page_table;
+    ctx->frame_pool = frame_pool;
+    ctx->frame_cnt = frame_cnt;
+    if(context_seed(ctx) != 0){
+        page_context_destroy(ctx);
+        return NULL;
+    }
+    return ctx;
+}
+
+void page_context_view(struct PAGE_CONTEXT *ctx,
+struct PTE page_table[],
+int table_cnt,
+int frame_pool[],
+int frame_cnt,
+int policy)
+{
+    /*Fills in a context that lives on the caller's stack and has no engine. Each fault with no free
+frame scans the page table for the page to replace, so a view costs nothing to set up and suits a
+single access. A view must not be passed to page_context_destroy.*/
+    ctx->policy = policy;
+    ctx->page_table = page_table;
+    ctx->table_cnt = table_cnt;
+    ctx->frame_pool = frame_pool;
+    ctx->frame_cnt = frame_cnt;
+    ctx->pool_cnt = frame_cnt;
+    ctx->timestamp = 1;
+    ctx->page_hits = 0;
+    ctx->page_faults = 0;
+    ctx->evictions = 0;
+    ctx->ghost_hits = 0;
+    ctx->evicted_page = -1;
+    ctx->has_engine = 0;
+    ctx->last_reference = NULL;
+    ctx->loaded_at = NULL;
+    ctx->arena = NULL;
+}
+
+void page_context_destroy(struct PAGE_CONTEXT *ctx)
+{
+    if(ctx != NULL){
+        free(ctx->arena); //the context itself lives in the arena
+    }
+}
+
+int page_context_reset(struct PAGE_CONTEXT *ctx, int policy, int frame_cnt)
+{
+    /*Starts a new simulation in an existing context: every page-table entry is marked invalid, the
+frame pool is refilled with frames 0 to frame_cnt - 1 and the counters and timestamp start over.
+Returns -1 if the policy is invalid or frame_cnt is larger than the pool.*/
+    if(!valid_policy(policy) || frame_cnt < 0 || frame_cnt > ctx->pool_cnt){
+        return -1;
+    }
+    for(int i = 0; i < ctx->table_cnt; i++){
+        ctx->page_table[i].is_valid = 0;
+        ctx->page_table[i].frame_number = -1;
+        ctx->page_table[i].arrival_timestamp = -1;
+        ctx->page_table[i].last_access_timestamp = -1;
+        ctx->page_table[i].reference_count = -1;
+        ctx->page_table[i].reference_bit = 0;
+    }
+    for(int i = 0; ctx->last_reference != NULL && i < ctx->table_cnt; i++){
+        ctx->last_reference[i] = -1; //the timestamps start over
+        ctx->loaded_at[i] = -1;
+    }
+    for(int i = 0; i < frame_cnt; i++){
+        ctx->frame_pool[i] = i;
+    }
+    ctx->policy = policy;
+    ctx->frame_cnt = frame_cnt;
+    ctx->timestamp = 1;
+    ctx->page_hits = 0;
+    ctx->page_faults = 0;
+    ctx->evictions = 0;
+    ctx->ghost_hits = 0;
+    ctx->evicted_page = -1;
+    if(ctx->has_engine){
+        return context_seed(ctx); //table is empty so this cannot fail
+    }
+    return 0;
+}
+
+static int clock_scan(struct PAGE_CONTEXT *ctx, int current_timestamp)
+{
+    /*Finds the page the CLOCK hand stops at in two passes over the page table, however many second
+chances it hands out. The hand looks at pages in order of arrival_timestamp and then page number and
+stops at the first one with a clear reference_bit, so the first pass finds that page and the second
+gives every page before it its second chance. If every bit is set, every page gets one and the hand
+comes round to the lowest page number.*/
+    struct PTE *page_table = ctx->page_table;
+    int victim = -1;
+    int lowest = -1;
+
+    for(int i = 0; i < ctx->table_cnt; i++){
+        if(page_table[i].is_valid == 0){
+            continue;
+        }
+        if(lowest == -1){
+            lowest = i;
+        }
+        if(page_table[i].reference_bit == 0 && (victim == -1 || page_table[i].arrival_timestamp < page_table[victim].arrival_timestamp)){
+            victim = i;
+        }
+    }
+    for(int i = 0; i < ctx->table_cnt; i++){
+        if(page_table[i].is_valid == 0 || page_table[i].reference_bit == 0){
+            continue;
+        }
+        if(victim == -1 || page_table[i].arrival_timestamp < page_table[victim].arrival_timestamp
+            || (page_table[i].arrival_timestamp == page_table[victim].arrival_timestamp && i < victim)){
+            page_table[i].reference_bit = 0; //second chance
+            page_table[i].arrival_timestamp = current_timestamp;
+        }
+    }
+    return victim != -1 ? victim : lowest;
+}
+
+static int victim_scan(struct PAGE_CONTEXT *ctx, int current_timestamp)
+{
+    /*Finds the page to replace by looking at every page in memory. FIFO picks the smallest
+arrival_timestamp, LRU the smallest last_access_timestamp and LFU the smallest reference_count with
+the smallest arrival_timestamp breaking ties. Remaining ties go to the lowest page number. CLOCK
+looks at pages in FIFO order and gives each one with its reference_bit set a second chance, clearing
+the bit and making it arrive again at current_timestamp (see clock_scan).*/
+    struct PTE *page_table = ctx->page_table;
+    int victim = -1;
+
+    if(ctx->policy == POLICY_CLOCK){
+        return clock_scan(ctx, current_timestamp);
+    }
+    for(int i = 0; i < ctx->table_cnt; i++){
+        if(page_table[i].is_valid == 0){
+            continue;
+        }
+        if(victim == -1){
+            victim = i;
+        }
+        else if(ctx->policy == POLICY_FIFO){
+            if(page_table[i].arrival_timestamp < page_table[victim].arrival_timestamp){
+                victim = i;
+            }
+        }
+        else if(ctx->policy == POLICY_LRU){
+            if(page_table[i].last_access_timestamp < page_table[victim].last_access_timestamp){
+                victim = i;
+            }
+        }
+        else if(MAX(page_table[i].reference_count, 1) < MAX(page_table[victim].reference_count, 1)
+            || (MAX(page_table[i].reference_count, 1) == MAX(page_table[victim].reference_count, 1)
+                && page_table[i].arrival_timestamp < page_table[victim].arrival_timestamp)){
+            victim = i; //a prefetched page, with a count of 0, ranks as referenced once
+        }
+    }
+    return victim;
+}
+
+static int context_victim(struct PAGE_CONTEXT *ctx, int current_timestamp)
+{
+    //the page the next fault will replace, -1 if nothing is in memory
+    if(!ctx->has_engine){
+        return victim_scan(ctx, current_timestamp);
+    }
+    if(ctx->policy == POLICY_CLOCK){
+        return clock_list_victim(&ctx->list, ctx->page_table, current_timestamp);
+    }
+    if(ctx->policy == POLICY_LFU){
+        return ctx->lfu.size > 0 ? ctx->lfu.heap[0] : -1;
+    }
+    return ctx->list.head;
+}
+
+static int context_access(struct PAGE_CONTEXT *ctx, int page_number, int current_timestamp, int prefetch)
+{
+    /*The function determines the memory frame number for the logical page and returns this number.
+
+If the page is already in memory (the page-table entry has the valid bit true) its
+last_access_timestamp and reference_count are updated and its frame number returned. Otherwise, if
+the frame pool is not empty, a frame is removed from the pool and given to the page. Otherwise the
+policy's victim is marked invalid with frame_number, arrival_timestamp, last_access_timestamp and
+reference_count set to -1, and its frame is given to the page. A newly loaded page gets
+current_timestamp as its arrival and last access time and a reference_count of 1.
+
+CLOCK-Pro, ARC and 2Q decide what leaves memory inside their own engines, which also remember pages
+after evicting them, so they are handled apart from the other policies and need a context with an
+engine.
+
+A prefetch loads the page the same way but is neither a hit nor a fault, and leaves a page already in
+memory alone (see page_context_prefetch).
+
+Returns -1 if page_number is outside the page table or there is neither a free frame nor a page in
+memory to replace.*/
+    struct PTE *entry;
+    int victim = -1;
+    int hit;
+    int frame_number;
+
+    if(page_number < 0 || page_number >= ctx->table_cnt){
+        return -1;
+    }
+    entry = &ctx->page_table[page_number];
+    hit = entry->is_valid != 0;
+    ctx->evicted_page = -1;
+    if(prefetch && hit){
+        return entry->frame_number;
+    }
+    if(adaptive_policy(ctx->policy)){
+        if(!ctx->has_engine){
+            return -1;
+        }
+        //the engines count from when they were seeded, which is when the context's counters start over
+        switch(ctx->policy){
+        case POLICY_CLOCK_PRO:
+            frame_number = (prefetch ? clockpro_prefetch : clockpro_access)(&ctx->clockpro, ctx->page_table, page_number, ctx->frame_pool,
+                &ctx->frame_cnt, current_timestamp);
+            ctx->evictions = ctx->clockpro.evictions;
+            ctx->ghost_hits = ctx->clockpro.test_hits;
+            ctx->evicted_page = ctx->clockpro.evicted_page;
+            break;
+        case POLICY_ARC:
+            frame_number = (prefetch ? arc_prefetch : arc_access)(&ctx->arc, ctx->page_table, page_number, ctx->frame_pool, &ctx->frame_cnt,
+                current_timestamp);
+            ctx->evictions = ctx->arc.evictions;
+            ctx->ghost_hits = ctx->arc.b1_hits + ctx->arc.b2_hits;
+            ctx->evicted_page = ctx->arc.evicted_page;
+            break;
+        default:
+            frame_number = (prefetch ? two_queue_prefetch : two_queue_access)(&ctx->two_queue, ctx->page_table, page_number, ctx->frame_pool,
+                &ctx->frame_cnt, current_timestamp);
+            ctx->evictions = ctx->two_queue.evictions;
+            ctx->ghost_hits = ctx->two_queue.a1out_hits;
+            ctx->evicted_page = ctx->two_queue.evicted_page;
+            break;
+        }
+        if(frame_number == -1){
+            return -1;
+        }
+        ctx->page_hits += hit;
+        ctx->page_faults += !hit && !prefetch;
+        if(ctx->evicted_page != -1){
+            INSTRUMENT_EVICT(ctx, ctx->evicted_page, current_timestamp); //after the engine cleared its entry
+        }
+        INSTRUMENT_ACCESS(ctx, page_number, frame_number, hit, prefetch, current_timestamp);
+        return frame_number;
+    }
+    if(hit){
+        ctx->page_hits += 1;
+    }
+    else {
+        if(ctx->frame_cnt == 0){
+            victim = context_victim(ctx, current_timestamp);
+            if(victim == -1){
+                return -1;
+            }
+            ctx->evicted_page = victim;
+            ctx->evictions += 1;
+            INSTRUMENT_EVICT(ctx, victim, current_timestamp); //before its entry is cleared
+        }
+        ctx->page_faults += !prefetch;
+    }
+    if(ctx->has_engine){
+        switch(ctx->policy){
+        case POLICY_FIFO:
+            frame_number = fifo_list_access(&ctx->list, ctx->page_table, page_number, ctx->frame_pool, &ctx->frame_cnt, current_timestamp);
+            break;
+        case POLICY_LRU:
+            frame_number = lru_list_access(&ctx->list, ctx->page_table, page_number, ctx->frame_pool, &ctx->frame_cnt, current_timestamp);
+            break;
+        case POLICY_CLOCK:
+            frame_number = clock_list_access(&ctx->list, ctx->page_table, page_number, ctx->frame_pool, &ctx->frame_cnt, current_timestamp);
+            break;
+        default:
+            frame_number = lfu_table_access(&ctx->lfu, ctx->page_table, page_number, ctx->frame_pool, &ctx->frame_cnt, current_timestamp);
+            break;
+        }
+        if(prefetch && frame_number != -1){
+            entry->reference_count = 0; //loaded but not referenced yet
+        }
+        INSTRUMENT_ACCESS(ctx, page_number, frame_number, hit, prefetch, current_timestamp);
+        return frame_number;
+    }
+
+    if(hit){
+        entry->reference_count += 1; //update reference count
+        entry->reference_bit = 1;
+        entry->last_access_timestamp = current_timestamp; //update time
+        INSTRUMENT_ACCESS(ctx, page_number, entry->frame_number, hit, prefetch, current_timestamp);
+        return entry->frame_number;
+    }
+    if(victim == -1){
+        ctx->frame_cnt -= 1; //lowers frame count
+        entry->frame_number = ctx->frame_pool[ctx->frame_cnt];
+    }
+    else {
+        entry->frame_number = ctx->page_table[victim].frame_number; //replaces the page in memory
+
+        ctx->page_table[victim].frame_number = -1;
+        ctx->page_table[victim].is_valid = 0;
+        ctx->page_table[victim].arrival_timestamp = -1;
+        ctx->page_table[victim].last_access_timestamp = -1;
+        ctx->page_table[victim].reference_count = -1;
+        ctx->page_table[victim].reference_bit = 0;
+    }
+    entry->is_valid = 1; //moved to memory so it is valid
+    entry->arrival_timestamp = current_timestamp;
+    entry->last_access_timestamp = current_timestamp;
+    entry->reference_count = prefetch ? 0 : 1;
+    entry->reference_bit = 1;
+    INSTRUMENT_ACCESS(ctx, page_number, entry->frame_number, hit, prefetch, current_timestamp);
+    return entry->frame_number;
+}
+
+int page_context_access(struct PAGE_CONTEXT *ctx, int page_number, int current_timestamp)
+{
+    return context_access(ctx, page_number, current_timestamp, 0);
+}
+
+int page_context_prefetch(struct PAGE_CONTEXT *ctx, int page_number, int current_timestamp)
+{
+    /*Loads the page ahead of its first reference, for a readahead, and returns its frame number. The
+page replaces like a fault would, but the load is neither a hit nor a fault, and a page already in
+memory is left alone. A prefetched page arrives at current_timestamp like a page that faulted in, but
+with a reference_count of 0, so its first reference is counted as a hit that brings it to 1, the same
+state as a page that faulted in. What the policies make of it:
+
+FIFO and LRU queue it like any page that arrives, or is used, at current_timestamp.
+CLOCK puts it behind the hand with its reference_bit set, as it does every page it loads.
+LFU ranks it with the pages referenced once, by its arrival.
+CLOCK-Pro loads it cold. It ends the test period of a test page without promoting it or adapting
+mem_cold, and its first reference does not set the reference_bit.
+ARC loads it onto t1 and forgets any ghost of it without adapting the target. Its first reference
+keeps it on t1, so a prefetched scan never reaches t2.
+2Q loads it onto a1in and forgets any ghost of it on a1out without counting a ghost hit.
+
+Returns -1 under the same conditions as page_context_access.*/
+    return context_access(ctx, page_number, current_timestamp, 1);
+}
+
+int page_context_run(struct PAGE_CONTEXT *ctx, int reference_string[], int reference_cnt)
+{
+    /*Processes a reference string, giving each access the context's next timestamp. Returns the number
+of page faults in this run, or -1 if an access fails or the timestamp reaches INT_MAX, which a context
+does INT_MAX - 1 references after it was created or reset.*/
+    long long page_faults = ctx->page_faults;
+
+    INSTRUMENT_RUN_BEGIN();
+    for(int i = 0; i < reference_cnt; i++){
+        if(ctx->timestamp == INT_MAX || page_context_access(ctx, reference_string[i], ctx->timestamp) == -1){
+            INSTRUMENT_RUN_END(i); //the references processed before the one that failed
+            return -1;
+        }
+        ctx->timestamp += 1;
+    }
+    INSTRUMENT_RUN_END(reference_cnt);
+    return (int)(ctx->page_faults - page_faults);
+}
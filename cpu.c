@@ -0,0 +1,424 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "oslabs.h"
+
+/*CPU scheduling. The handle_process_* functions declared for the lab keep the ready processes in an
+array the caller owns: an arrival starts on an idle CPU, preempts the running process (PP and SRTP
+only) or joins the array, and a completion scans the array for the next process to run, so every
+completion is O(n).
+
+A READY_QUEUE holds the ready processes itself and grows as needed. PP and SRTP keep them in a binary
+heap keyed on process_priority or remaining_bursttime, with the order they were queued breaking ties,
+so a completion is O(log n). RR keeps them in a ring buffer, so a completion takes the head in O(1).
+The queue makes the same choices as the array functions, and cpu_replay runs a whole trace through it.
+
+A running process has execution_endtime set to when it finishes, or under RR to when its time quantum
+runs out. A preempted process goes back to the queue with remaining_bursttime set to what it has left
+and execution_endtime cleared. Lower process_priority values run first.*/
+
+static struct PCB null_pcb(void)
+{
+    struct PCB process = { 0, 0, 0, 0, 0, 0, 0 };
+
+    return process;
+}
+
+static int is_null_pcb(struct PCB process)
+{
+    return process.process_id == 0 && process.arrival_timestamp == 0 && process.total_bursttime == 0
+        && process.execution_starttime == 0 && process.execution_endtime == 0 && process.remaining_bursttime == 0
+        && process.process_priority == 0;
+}
+
+static struct PCB process_ready(struct PCB process)
+{
+    //a new arrival waiting for its first turn
+    process.execution_starttime = 0;
+    process.execution_endtime = 0;
+    process.remaining_bursttime = process.total_bursttime;
+    return process;
+}
+
+static struct PCB process_start(struct PCB process, int timestamp, int time_quantum)
+{
+    //runs the process from timestamp, for one time quantum if time_quantum is positive
+    int run = time_quantum > 0 ? MIN(time_quantum, process.remaining_bursttime) : process.remaining_bursttime;
+
+    process.execution_starttime = timestamp;
+    process.execution_endtime = timestamp + run;
+    return process;
+}
+
+static struct PCB process_preempt(struct PCB process, int timestamp)
+{
+    process.remaining_bursttime = process.execution_endtime - timestamp;
+    process.execution_endtime = 0;
+    return process;
+}
+
+static int preempts(int policy, struct PCB *running, struct PCB *arriving, int timestamp)
+{
+    //whether the arriving process takes the CPU from the running one
+    if(policy == CPU_PP){
+        return arriving->process_priority < running->process_priority;
+    }
+    if(policy == CPU_SRTP){
+        return arriving->total_bursttime < running->execution_endtime - timestamp;
+    }
+    return 0;
+}
+
+static int runs_before(int policy, struct PCB *a, struct PCB *b)
+{
+    //whether a completion picks a over b, which was queued earlier
+    if(policy == CPU_PP){
+        return a->process_priority < b->process_priority;
+    }
+    return a->remaining_bursttime < b->remaining_bursttime;
+}
+
+static struct PCB array_arrival(int policy,
+struct PCB ready_queue[],
+int *queue_cnt,
+struct PCB current_process,
+struct PCB new_process,
+int timestamp,
+int time_quantum)
+{
+    new_process = process_ready(new_process);
+    if(is_null_pcb(current_process)){
+        return process_start(new_process, timestamp, time_quantum);
+    }
+    if(preempts(policy, &current_process, &new_process, timestamp)){
+        ready_queue[(*queue_cnt)++] = process_preempt(current_process, timestamp);
+        return process_start(new_process, timestamp, time_quantum);
+    }
+    ready_queue[(*queue_cnt)++] = new_process;
+    return current_process;
+}
+
+static struct PCB array_completion(int policy, struct PCB ready_queue[], int *queue_cnt, int timestamp, int time_quantum)
+{
+    //takes the next process out of the array, keeping the rest in queue order for the tie-breaks
+    struct PCB process;
+    int best = 0;
+
+    if(*queue_cnt == 0){
+        return null_pcb();
+    }
+    for(int i = 1; i < *queue_cnt && policy != CPU_RR; i++){
+        if(runs_before(policy, &ready_queue[i], &ready_queue[best])){
+            best = i;
+        }
+    }
+    process = ready_queue[best];
+    for(int i = best + 1; i < *queue_cnt; i++){
+        ready_queue[i - 1] = ready_queue[i];
+    }
+    *queue_cnt -= 1;
+    return process_start(process, timestamp, time_quantum);
+}
+
+struct PCB handle_process_arrival_pp(struct PCB ready_queue[QUEUEMAX],
+int *queue_cnt,
+struct PCB current_process,
+struct PCB new_process,
+int timestamp)
+{
+    /*Returns the process that runs after new_process arrives. On an idle CPU (current_process all
+zeros) new_process starts at once. If it has a lower process_priority than the running process, that
+one is preempted into the queue and new_process starts. Otherwise new_process joins the queue.
+ready_queue needs room for one more process than *queue_cnt, QUEUEMAX is only the size the lab used.*/
+    return array_arrival(CPU_PP, ready_queue, queue_cnt, current_process, new_process, timestamp, 0);
+}
+
+struct PCB handle_process_completion_pp(struct PCB ready_queue[QUEUEMAX], int *queue_cnt, int timestamp)
+{
+    //removes and starts the queued process with the lowest process_priority, all zeros if there is none
+    return array_completion(CPU_PP, ready_queue, queue_cnt, timestamp, 0);
+}
+
+struct PCB handle_process_arrival_srtp(struct PCB ready_queue[QUEUEMAX],
+int *queue_cnt,
+struct PCB current_process,
+struct PCB new_process,
+int time_stamp)
+{
+    //same as handle_process_arrival_pp, preempting when new_process needs less time than the running one has left
+    return array_arrival(CPU_SRTP, ready_queue, queue_cnt, current_process, new_process, time_stamp, 0);
+}
+
+struct PCB handle_process_completion_srtp(struct PCB ready_queue[QUEUEMAX], int *queue_cnt, int timestamp)
+{
+    //removes and starts the queued process with the least remaining_bursttime, all zeros if there is none
+    return array_completion(CPU_SRTP, ready_queue, queue_cnt, timestamp, 0);
+}
+
+struct PCB handle_process_arrival_rr(struct PCB ready_queue[QUEUEMAX],
+int *queue_cnt,
+struct PCB current_process,
+struct PCB new_process,
+int timestamp,
+int time_quantum)
+{
+    //new_process starts for one time quantum on an idle CPU and otherwise joins the back of the queue
+    return array_arrival(CPU_RR, ready_queue, queue_cnt, current_process, new_process, timestamp, time_quantum);
+}
+
+struct PCB handle_process_completion_rr(struct PCB ready_queue[QUEUEMAX], int *queue_cnt, int timestamp, int time_quantum)
+{
+    /*Removes the process at the front of the queue and starts it for one time quantum, all zeros if the
+queue is empty. A process whose quantum ran out goes to the back of the queue first, through
+ready_queue[(*queue_cnt)++].*/
+    return array_completion(CPU_RR, ready_queue, queue_cnt, timestamp, time_quantum);
+}
+
+static int slot_before(struct READY_QUEUE *rq, int a, int b)
+{
+    struct READY_SLOT *x = &rq->slots[a];
+    struct READY_SLOT *y = &rq->slots[b];
+
+    if(runs_before(rq->policy, &x->process, &y->process) || runs_before(rq->policy, &y->process, &x->process)){
+        return runs_before(rq->policy, &x->process, &y->process);
+    }
+    return x->order < y->order;
+}
+
+static void slot_swap(struct READY_QUEUE *rq, int a, int b)
+{
+    struct READY_SLOT slot = rq->slots[a];
+
+    rq->slots[a] = rq->slots[b];
+    rq->slots[b] = slot;
+}
+
+struct READY_QUEUE *ready_queue_create(int policy, int capacity)
+{
+    /*Creates an empty ready queue for policy, one of CPU_PP, CPU_SRTP and CPU_RR, with room for capacity
+processes before it first grows. Returns NULL if the policy is unknown or memory cannot be
+allocated.*/
+    struct READY_QUEUE *rq;
+
+    if(policy != CPU_PP && policy != CPU_SRTP && policy != CPU_RR){
+        return NULL;
+    }
+    rq = malloc(sizeof(struct READY_QUEUE));
+    if(rq == NULL){
+        return NULL;
+    }
+    rq->policy = policy;
+    rq->capacity = MAX(1, capacity);
+    rq->slots = malloc((size_t)rq->capacity * sizeof(struct READY_SLOT));
+    if(rq->slots == NULL){
+        free(rq);
+        return NULL;
+    }
+    rq->head = 0;
+    rq->queue_cnt = 0;
+    rq->order = 0;
+    return rq;
+}
+
+void ready_queue_destroy(struct READY_QUEUE *rq)
+{
+    if(rq != NULL){
+        free(rq->slots);
+        free(rq);
+    }
+}
+
+int ready_queue_push(struct READY_QUEUE *rq, struct PCB process)
+{
+    /*Queues the process as it is, for one that is already set up to wait, such as an RR process whose
+quantum ran out. Returns -1 if the queue cannot grow.*/
+    int index;
+
+    if(rq->queue_cnt == rq->capacity){
+        struct READY_SLOT *slots = malloc((size_t)rq->capacity * 2 * sizeof(struct READY_SLOT));
+
+        if(slots == NULL){
+            return -1;
+        }
+        for(int i = 0; i < rq->queue_cnt; i++){
+            slots[i] = rq->slots[(rq->head + i) % rq->capacity]; //a heap always has head 0
+        }
+        free(rq->slots);
+        rq->slots = slots;
+        rq->head = 0;
+        rq->capacity *= 2;
+    }
+    index = (rq->head + rq->queue_cnt) % rq->capacity;
+    rq->slots[index].process = process;
+    rq->slots[index].order = rq->order++;
+    rq->queue_cnt += 1;
+    while(rq->policy != CPU_RR && index > 0 && slot_before(rq, index, (index - 1) / 2)){
+        slot_swap(rq, index, (index - 1) / 2);
+        index = (index - 1) / 2;
+    }
+    return 0;
+}
+
+static struct PCB ready_queue_take(struct READY_QUEUE *rq)
+{
+    //removes the process a completion picks, the queue must not be empty
+    struct PCB process = rq->slots[rq->head].process;
+    int index = 0;
+
+    rq->queue_cnt -= 1;
+    if(rq->policy == CPU_RR){
+        rq->head = (rq->head + 1) % rq->capacity;
+        return process;
+    }
+    rq->slots[0] = rq->slots[rq->queue_cnt];
+    while(1){
+        int child = 2 * index + 1;
+        if(child >= rq->queue_cnt){
+            break;
+        }
+        if(child + 1 < rq->queue_cnt && slot_before(rq, child + 1, child)){
+            child += 1;
+        }
+        if(!slot_before(rq, child, index)){
+            break;
+        }
+        slot_swap(rq, index, child);
+        index = child;
+    }
+    return process;
+}
+
+static int queue_arrival(struct READY_QUEUE *rq,
+struct PCB current_process,
+struct PCB new_process,
+int timestamp,
+int time_quantum,
+struct PCB *running)
+{
+    //ready_queue_arrival, storing the running process in *running and returning -1 if a push failed
+    new_process = process_ready(new_process);
+    if(is_null_pcb(current_process)){
+        *running = process_start(new_process, timestamp, time_quantum);
+        return 0;
+    }
+    if(preempts(rq->policy, &current_process, &new_process, timestamp)){
+        if(ready_queue_push(rq, process_preempt(current_process, timestamp)) != 0){
+            return -1;
+        }
+        *running = process_start(new_process, timestamp, time_quantum);
+        return 0;
+    }
+    if(ready_queue_push(rq, new_process) != 0){
+        return -1;
+    }
+    *running = current_process;
+    return 0;
+}
+
+struct PCB ready_queue_arrival(struct READY_QUEUE *rq, struct PCB current_process, struct PCB new_process, int timestamp, int time_quantum)
+{
+    /*Same as handle_process_arrival_pp, _srtp or _rr, picked by the queue's policy. Returns all zeros if
+a process has to be queued and the queue cannot grow, which a process with every field 0 started at
+time 0 also looks like.*/
+    struct PCB running;
+
+    if(queue_arrival(rq, current_process, new_process, timestamp, time_quantum, &running) != 0){
+        return null_pcb();
+    }
+    return running;
+}
+
+struct PCB ready_queue_completion(struct READY_QUEUE *rq, int timestamp, int time_quantum)
+{
+    //same as handle_process_completion_pp, _srtp or _rr, picked by the queue's policy
+    if(rq->queue_cnt == 0){
+        return null_pcb();
+    }
+    return process_start(ready_queue_take(rq), timestamp, time_quantum);
+}
+
+int cpu_replay(int policy, struct PCB processes[], int process_cnt, int time_quantum, struct CPU_STATS *stats)
+{
+    /*Runs the processes, which must be sorted by arrival_timestamp, on one CPU under policy. A process
+that finishes at the moment another arrives finishes first, and under RR the arrivals join the queue
+before a process whose quantum ran out. Fills in stats and returns 0, or -1 if the policy is unknown,
+time_quantum is not positive under CPU_RR, the processes are out of order or memory runs out.*/
+    struct READY_QUEUE *rq;
+    struct PCB current = null_pcb();
+    long long start_ns;
+    int running = 0;
+    int now;
+    int next = 0;
+
+    stats->processes = 0;
+    stats->dispatches = 0;
+    stats->total_turnaround = 0;
+    stats->total_waiting = 0;
+    stats->max_waiting = 0;
+    stats->makespan = 0;
+    stats->elapsed_ns = 0;
+    if(policy == CPU_RR && time_quantum <= 0){
+        return -1;
+    }
+    for(int i = 1; i < process_cnt; i++){
+        if(processes[i].arrival_timestamp < processes[i - 1].arrival_timestamp){
+            return -1;
+        }
+    }
+    rq = ready_queue_create(policy, 1024);
+    if(rq == NULL){
+        return -1;
+    }
+    if(policy != CPU_RR){
+        time_quantum = 0;
+    }
+    now = process_cnt > 0 ? processes[0].arrival_timestamp : 0;
+    start_ns = monotonic_ns();
+    while(stats->processes < process_cnt){
+        if(!running && rq->queue_cnt > 0){
+            current = ready_queue_completion(rq, now, time_quantum);
+            stats->dispatches += 1;
+            running = 1;
+            continue;
+        }
+        if(!running || (next < process_cnt && processes[next].arrival_timestamp < current.execution_endtime)){
+            struct PCB arriving = processes[next++];
+
+            now = MAX(now, arriving.arrival_timestamp);
+            stats->dispatches += !running || preempts(policy, &current, &arriving, now);
+            if(queue_arrival(rq, running ? current : null_pcb(), arriving, now, time_quantum, &current) != 0){
+                ready_queue_destroy(rq);
+                return -1;
+            }
+            running = 1;
+            continue;
+        }
+        now = current.execution_endtime;
+        current.remaining_bursttime -= current.execution_endtime - current.execution_starttime;
+        while(next < process_cnt && processes[next].arrival_timestamp <= now){
+            if(ready_queue_push(rq, process_ready(processes[next++])) != 0){
+                ready_queue_destroy(rq);
+                return -1;
+            }
+        }
+        if(current.remaining_bursttime > 0){
+            current.execution_endtime = 0; //its quantum ran out
+            if(ready_queue_push(rq, current) != 0){
+                ready_queue_destroy(rq);
+                return -1;
+            }
+        }
+        else {
+            long long turnaround = (long long)now - current.arrival_timestamp;
+
+            stats->processes += 1;
+            stats->total_turnaround += turnaround;
+            stats->total_waiting += turnaround - current.total_bursttime;
+            stats->max_waiting = MAX(stats->max_waiting, turnaround - current.total_bursttime);
+        }
+        running = 0;
+    }
+    stats->elapsed_ns = monotonic_ns() - start_ns;
+    stats->makespan = process_cnt > 0 ? (long long)now - processes[0].arrival_timestamp : 0;
+    ready_queue_destroy(rq);
+    return 0;
+}
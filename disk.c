@@ -0,0 +1,547 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "oslabs.h"
+
+/*Disk scheduling. The handle_request_* functions declared for the lab keep the waiting requests in
+an array the caller owns: an arrival either starts service on an idle disk or joins the array, and a
+completion scans the array for the next request and closes the gap, so every completion is O(n).
+
+A DISK_QUEUE holds the waiting requests itself and picks the same request in O(log n). FCFS keeps them
+in a binary heap ordered by arrival. SSTF and LOOK keep them in a treap ordered by cylinder, then
+arrival, then the order they were queued, so the nearest request on either side of the head is one
+walk down the tree. The queue grows as needed.
+
+Both break ties the same way: the earliest arrival, then the request queued first. disk_replay runs a
+trace through a DISK_QUEUE with a simple seek and transfer time model and reports the seek distance,
+response times and throughput.*/
+
+static struct RCB null_rcb(void)
+{
+    struct RCB request = { 0, 0, 0, 0, 0 };
+
+    return request;
+}
+
+static int is_null_rcb(struct RCB request)
+{
+    return request.request_id == 0 && request.arrival_timestamp == 0 && request.cylinder == 0
+        && request.address == 0 && request.process_id == 0;
+}
+
+static int distance(int a, int b)
+{
+    return a > b ? a - b : b - a;
+}
+
+static struct RCB request_arrival(struct RCB request_queue[],
+int *queue_cnt,
+struct RCB current_request,
+struct RCB new_request)
+{
+    //an idle disk serves the new request at once, a busy one queues it
+    if(is_null_rcb(current_request)){
+        return new_request;
+    }
+    request_queue[*queue_cnt] = new_request;
+    *queue_cnt += 1;
+    return current_request;
+}
+
+static struct RCB request_take(struct RCB request_queue[], int *queue_cnt, int index)
+{
+    //removes the request, keeping the rest in queue order so ties still go to the earlier one
+    struct RCB request = request_queue[index];
+
+    for(int i = index + 1; i < *queue_cnt; i++){
+        request_queue[i - 1] = request_queue[i];
+    }
+    *queue_cnt -= 1;
+    return request;
+}
+
+static int look_better(struct RCB *a, struct RCB *b, int current_cylinder, int scan_direction)
+{
+    /*Whether LOOK serves a before b: a request on the head's cylinder first, then one ahead in the scan
+direction, nearest first, then one behind, nearest first, and the earlier arrival among equals.*/
+    int side_a = a->cylinder == current_cylinder ? 0 : (a->cylinder > current_cylinder) == (scan_direction == 1) ? 1 : 2;
+    int side_b = b->cylinder == current_cylinder ? 0 : (b->cylinder > current_cylinder) == (scan_direction == 1) ? 1 : 2;
+
+    if(side_a != side_b){
+        return side_a < side_b;
+    }
+    if(distance(a->cylinder, current_cylinder) != distance(b->cylinder, current_cylinder)){
+        return distance(a->cylinder, current_cylinder) < distance(b->cylinder, current_cylinder);
+    }
+    return a->arrival_timestamp < b->arrival_timestamp;
+}
+
+struct RCB handle_request_arrival_fcfs(struct RCB request_queue[QUEUEMAX],
+int *queue_cnt,
+struct RCB current_request,
+struct RCB new_request,
+int timestamp)
+{
+    /*Returns the request the disk serves after new_request arrives: new_request itself if the disk was
+idle (current_request is all zeros), otherwise current_request, with new_request added to the queue.
+request_queue needs room for one more request than *queue_cnt, QUEUEMAX is only the size the lab used.
+SSTF and LOOK handle arrivals the same way.*/
+    (void)timestamp;
+    return request_arrival(request_queue, queue_cnt, current_request, new_request);
+}
+
+struct RCB handle_request_completion_fcfs(struct RCB request_queue[QUEUEMAX], int *queue_cnt)
+{
+    //removes and returns the earliest arrival in the queue, all zeros if it is empty
+    int best = 0;
+
+    if(*queue_cnt == 0){
+        return null_rcb();
+    }
+    for(int i = 1; i < *queue_cnt; i++){
+        if(request_queue[i].arrival_timestamp < request_queue[best].arrival_timestamp){
+            best = i;
+        }
+    }
+    return request_take(request_queue, queue_cnt, best);
+}
+
+struct RCB handle_request_arrival_sstf(struct RCB request_queue[QUEUEMAX],
+int *queue_cnt,
+struct RCB current_request,
+struct RCB new_request,
+int timestamp)
+{
+    (void)timestamp;
+    return request_arrival(request_queue, queue_cnt, current_request, new_request);
+}
+
+struct RCB handle_request_completion_sstf(struct RCB request_queue[QUEUEMAX], int *queue_cnt, int current_cylinder)
+{
+    //removes and returns the request nearest current_cylinder, the earliest arrival among equals
+    int best = 0;
+
+    if(*queue_cnt == 0){
+        return null_rcb();
+    }
+    for(int i = 1; i < *queue_cnt; i++){
+        int d = distance(request_queue[i].cylinder, current_cylinder);
+        int best_d = distance(request_queue[best].cylinder, current_cylinder);
+
+        if(d < best_d || (d == best_d && request_queue[i].arrival_timestamp < request_queue[best].arrival_timestamp)){
+            best = i;
+        }
+    }
+    return request_take(request_queue, queue_cnt, best);
+}
+
+struct RCB handle_request_arrival_look(struct RCB request_queue[QUEUEMAX],
+int *queue_cnt,
+struct RCB current_request,
+struct RCB new_request,
+int timestamp)
+{
+    (void)timestamp;
+    return request_arrival(request_queue, queue_cnt, current_request, new_request);
+}
+
+struct RCB handle_request_completion_look(struct RCB request_queue[QUEUEMAX],
+int *queue_cnt,
+int current_cylinder,
+int scan_direction)
+{
+    /*Removes and returns the next request of a LOOK scan moving up (scan_direction 1) or down (0): the
+earliest arrival on current_cylinder, otherwise the nearest request ahead, otherwise the nearest one
+behind, where the scan turns around. All zeros if the queue is empty.*/
+    int best = 0;
+
+    if(*queue_cnt == 0){
+        return null_rcb();
+    }
+    for(int i = 1; i < *queue_cnt; i++){
+        if(look_better(&request_queue[i], &request_queue[best], current_cylinder, scan_direction)){
+            best = i;
+        }
+    }
+    return request_take(request_queue, queue_cnt, best);
+}
+
+static int node_before(struct DISK_QUEUE *dq, int a, int b)
+{
+    //queue order: cylinder first for SSTF and LOOK, then arrival, then the order they were queued
+    struct DISK_NODE *x = &dq->nodes[a];
+    struct DISK_NODE *y = &dq->nodes[b];
+
+    if(dq->policy != DISK_FCFS && x->request.cylinder != y->request.cylinder){
+        return x->request.cylinder < y->request.cylinder;
+    }
+    if(x->request.arrival_timestamp != y->request.arrival_timestamp){
+        return x->request.arrival_timestamp < y->request.arrival_timestamp;
+    }
+    return x->order < y->order;
+}
+
+static void heap_sift_up(struct DISK_QUEUE *dq, int index)
+{
+    int id = dq->heap[index];
+
+    while(index > 0 && node_before(dq, id, dq->heap[(index - 1) / 2])){
+        dq->heap[index] = dq->heap[(index - 1) / 2];
+        index = (index - 1) / 2;
+    }
+    dq->heap[index] = id;
+}
+
+static void heap_sift_down(struct DISK_QUEUE *dq, int index)
+{
+    int id = dq->heap[index];
+
+    while(1){
+        int child = 2 * index + 1;
+        if(child >= dq->queue_cnt){
+            break;
+        }
+        if(child + 1 < dq->queue_cnt && node_before(dq, dq->heap[child + 1], dq->heap[child])){
+            child += 1;
+        }
+        if(!node_before(dq, dq->heap[child], id)){
+            break;
+        }
+        dq->heap[index] = dq->heap[child];
+        index = child;
+    }
+    dq->heap[index] = id;
+}
+
+static void tree_split(struct DISK_QUEUE *dq, int tree, int id, int *low, int *high)
+{
+    //splits tree into the nodes ordered before id and the rest
+    if(tree == -1){
+        *low = -1;
+        *high = -1;
+    }
+    else if(node_before(dq, tree, id)){
+        tree_split(dq, dq->nodes[tree].right, id, &dq->nodes[tree].right, high);
+        *low = tree;
+    }
+    else {
+        tree_split(dq, dq->nodes[tree].left, id, low, &dq->nodes[tree].left);
+        *high = tree;
+    }
+}
+
+static int tree_merge(struct DISK_QUEUE *dq, int low, int high)
+{
+    if(low == -1){
+        return high;
+    }
+    if(high == -1){
+        return low;
+    }
+    if(dq->nodes[low].priority > dq->nodes[high].priority){
+        dq->nodes[low].right = tree_merge(dq, dq->nodes[low].right, high);
+        return low;
+    }
+    dq->nodes[high].left = tree_merge(dq, low, dq->nodes[high].left);
+    return high;
+}
+
+static int tree_insert(struct DISK_QUEUE *dq, int tree, int id)
+{
+    if(tree == -1 || dq->nodes[id].priority > dq->nodes[tree].priority){
+        tree_split(dq, tree, id, &dq->nodes[id].left, &dq->nodes[id].right);
+        return id;
+    }
+    if(node_before(dq, id, tree)){
+        dq->nodes[tree].left = tree_insert(dq, dq->nodes[tree].left, id);
+    }
+    else {
+        dq->nodes[tree].right = tree_insert(dq, dq->nodes[tree].right, id);
+    }
+    return tree;
+}
+
+static int tree_remove(struct DISK_QUEUE *dq, int tree, int id)
+{
+    if(tree == id){
+        return tree_merge(dq, dq->nodes[id].left, dq->nodes[id].right);
+    }
+    if(node_before(dq, id, tree)){
+        dq->nodes[tree].left = tree_remove(dq, dq->nodes[tree].left, id);
+    }
+    else {
+        dq->nodes[tree].right = tree_remove(dq, dq->nodes[tree].right, id);
+    }
+    return tree;
+}
+
+static int tree_at_or_above(struct DISK_QUEUE *dq, int cylinder)
+{
+    //earliest request on the lowest cylinder at or above cylinder, -1 if none
+    int found = -1;
+
+    for(int id = dq->root; id != -1; ){
+        if(dq->nodes[id].request.cylinder >= cylinder){
+            found = id;
+            id = dq->nodes[id].left;
+        }
+        else {
+            id = dq->nodes[id].right;
+        }
+    }
+    return found;
+}
+
+static int tree_below(struct DISK_QUEUE *dq, int cylinder)
+{
+    //earliest request on the highest cylinder below cylinder, -1 if none
+    int found = -1;
+
+    for(int id = dq->root; id != -1; ){
+        if(dq->nodes[id].request.cylinder < cylinder){
+            found = id;
+            id = dq->nodes[id].right;
+        }
+        else {
+            id = dq->nodes[id].left;
+        }
+    }
+    return found == -1 ? -1 : tree_at_or_above(dq, dq->nodes[found].request.cylinder);
+}
+
+static int tree_above(struct DISK_QUEUE *dq, int cylinder)
+{
+    //earliest request on the lowest cylinder above cylinder, -1 if none
+    return cylinder == 2147483647 ? -1 : tree_at_or_above(dq, cylinder + 1);
+}
+
+static int disk_queue_resize(struct DISK_QUEUE *dq, int capacity)
+{
+    //moves the queue to room for capacity requests, keeping every node id
+    struct ARENA arena;
+    struct DISK_NODE *nodes;
+    int *heap;
+    int *spare_ids;
+
+    arena.base = malloc(arena_size((size_t)capacity * sizeof(struct DISK_NODE)) + 2 * arena_size((size_t)capacity * sizeof(int)));
+    arena.used = 0;
+    if(arena.base == NULL){
+        return -1;
+    }
+    nodes = arena_take(&arena, (size_t)capacity * sizeof(struct DISK_NODE));
+    heap = arena_take(&arena, (size_t)capacity * sizeof(int));
+    spare_ids = arena_take(&arena, (size_t)capacity * sizeof(int));
+    for(int i = 0; i < dq->capacity; i++){
+        nodes[i] = dq->nodes[i];
+    }
+    for(int i = 0; i < dq->queue_cnt && dq->policy == DISK_FCFS; i++){
+        heap[i] = dq->heap[i];
+    }
+    for(int i = 0; i < dq->spare_cnt; i++){
+        spare_ids[i] = dq->spare_ids[i];
+    }
+    for(int id = capacity - 1; id >= dq->capacity; id--){
+        spare_ids[dq->spare_cnt++] = id; //lowest new id is handed out first
+    }
+    free(dq->arena);
+    dq->arena = arena.base;
+    dq->nodes = nodes;
+    dq->heap = heap;
+    dq->spare_ids = spare_ids;
+    dq->capacity = capacity;
+    return 0;
+}
+
+struct DISK_QUEUE *disk_queue_create(int policy, int capacity)
+{
+    /*Creates an empty queue for policy, one of DISK_FCFS, DISK_SSTF and DISK_LOOK, with room for
+capacity requests before it first grows. Returns NULL if the policy is unknown or memory cannot be
+allocated.*/
+    struct DISK_QUEUE *dq;
+
+    if(policy != DISK_FCFS && policy != DISK_SSTF && policy != DISK_LOOK){
+        return NULL;
+    }
+    dq = malloc(sizeof(struct DISK_QUEUE));
+    if(dq == NULL){
+        return NULL;
+    }
+    dq->policy = policy;
+    dq->nodes = NULL;
+    dq->heap = NULL;
+    dq->spare_ids = NULL;
+    dq->spare_cnt = 0;
+    dq->capacity = 0;
+    dq->queue_cnt = 0;
+    dq->root = -1;
+    dq->order = 0;
+    dq->rng_state = XORSHIFT64_SEED;
+    dq->arena = NULL;
+    if(disk_queue_resize(dq, MAX(1, capacity)) != 0){
+        free(dq);
+        return NULL;
+    }
+    return dq;
+}
+
+void disk_queue_destroy(struct DISK_QUEUE *dq)
+{
+    if(dq != NULL){
+        free(dq->arena);
+        free(dq);
+    }
+}
+
+int disk_queue_push(struct DISK_QUEUE *dq, struct RCB request)
+{
+    //queues the request, growing the queue if it is full. Returns -1 if it cannot grow
+    struct DISK_NODE *node;
+    int id;
+
+    if(dq->spare_cnt == 0 && disk_queue_resize(dq, dq->capacity * 2) != 0){
+        return -1;
+    }
+    id = dq->spare_ids[--dq->spare_cnt];
+    node = &dq->nodes[id];
+    node->request = request;
+    node->order = dq->order++;
+    if(dq->policy == DISK_FCFS){
+        dq->heap[dq->queue_cnt] = id;
+        dq->queue_cnt += 1;
+        heap_sift_up(dq, dq->queue_cnt - 1);
+        return 0;
+    }
+    node->priority = (unsigned int)(xorshift64(&dq->rng_state) >> 32);
+    node->left = -1;
+    node->right = -1;
+    dq->root = tree_insert(dq, dq->root, id);
+    dq->queue_cnt += 1;
+    return 0;
+}
+
+struct RCB disk_queue_pop(struct DISK_QUEUE *dq, int current_cylinder, int scan_direction)
+{
+    /*Removes and returns the request handle_request_completion_fcfs, _sstf or _look would pick from the
+same requests, given the head's cylinder and, for LOOK, the scan direction (1 up, 0 down). The
+arguments a policy does not use are ignored. All zeros if the queue is empty.*/
+    int id;
+
+    if(dq->queue_cnt == 0){
+        return null_rcb();
+    }
+    if(dq->policy == DISK_FCFS){
+        id = dq->heap[0];
+        dq->queue_cnt -= 1;
+        if(dq->queue_cnt > 0){
+            dq->heap[0] = dq->heap[dq->queue_cnt];
+            heap_sift_down(dq, 0);
+        }
+        dq->spare_ids[dq->spare_cnt++] = id;
+        return dq->nodes[id].request;
+    }
+    id = tree_at_or_above(dq, current_cylinder);
+    if(id == -1 || dq->nodes[id].request.cylinder != current_cylinder){
+        int above = tree_above(dq, current_cylinder);
+        int below = tree_below(dq, current_cylinder);
+
+        if(dq->policy == DISK_LOOK){
+            id = scan_direction == 1 ? (above != -1 ? above : below) : (below != -1 ? below : above);
+        }
+        else if(above == -1 || below == -1){
+            id = above == -1 ? below : above;
+        }
+        else {
+            int d_above = distance(dq->nodes[above].request.cylinder, current_cylinder);
+            int d_below = distance(dq->nodes[below].request.cylinder, current_cylinder);
+            struct RCB *a = &dq->nodes[above].request;
+            struct RCB *b = &dq->nodes[below].request;
+
+            if(d_above != d_below){
+                id = d_above < d_below ? above : below;
+            }
+            else if(a->arrival_timestamp != b->arrival_timestamp){
+                id = a->arrival_timestamp < b->arrival_timestamp ? above : below;
+            }
+            else {
+                id = dq->nodes[above].order < dq->nodes[below].order ? above : below;
+            }
+        }
+    }
+    dq->root = tree_remove(dq, dq->root, id);
+    dq->queue_cnt -= 1;
+    dq->spare_ids[dq->spare_cnt++] = id;
+    return dq->nodes[id].request;
+}
+
+int disk_replay(int policy,
+struct RCB requests[],
+int request_cnt,
+int start_cylinder,
+int seek_time,
+int transfer_time,
+struct DISK_STATS *stats)
+{
+    /*Serves the requests, which must be sorted by arrival_timestamp, on a disk whose head starts at
+start_cylinder moving up. Whenever the disk is free it admits every request that has arrived and
+serves the one the policy picks, taking seek_time per cylinder travelled plus transfer_time. A LOOK
+scan turns around when the request it picks lies behind the head. Fills in stats and returns 0, or -1
+if the policy is unknown, the requests are out of order or memory runs out.*/
+    struct DISK_QUEUE *dq;
+    long long now;
+    long long start_ns;
+    int head = start_cylinder;
+    int scan_direction = 1;
+    int next = 0;
+
+    stats->requests = 0;
+    stats->seek_distance = 0;
+    stats->busy_time = 0;
+    stats->total_response = 0;
+    stats->max_response = 0;
+    stats->makespan = 0;
+    stats->elapsed_ns = 0;
+    for(int i = 1; i < request_cnt; i++){
+        if(requests[i].arrival_timestamp < requests[i - 1].arrival_timestamp){
+            return -1;
+        }
+    }
+    dq = disk_queue_create(policy, 1024);
+    if(dq == NULL){
+        return -1;
+    }
+    now = request_cnt > 0 ? requests[0].arrival_timestamp : 0;
+    start_ns = monotonic_ns();
+    while(stats->requests < request_cnt){
+        struct RCB request;
+        long long service;
+        long long response;
+
+        while(next < request_cnt && requests[next].arrival_timestamp <= now){
+            if(disk_queue_push(dq, requests[next]) != 0){
+                disk_queue_destroy(dq);
+                return -1;
+            }
+            next += 1;
+        }
+        if(dq->queue_cnt == 0){
+            now = requests[next].arrival_timestamp; //idle until the next arrival
+            continue;
+        }
+        request = disk_queue_pop(dq, head, scan_direction);
+        if(request.cylinder != head){
+            scan_direction = request.cylinder > head;
+        }
+        service = (long long)distance(request.cylinder, head) * seek_time + transfer_time;
+        stats->seek_distance += distance(request.cylinder, head);
+        stats->busy_time += service;
+        head = request.cylinder;
+        now += service;
+        response = now - request.arrival_timestamp;
+        stats->total_response += response;
+        stats->max_response = MAX(stats->max_response, response);
+        stats->requests += 1;
+    }
+    stats->elapsed_ns = monotonic_ns() - start_ns;
+    stats->makespan = request_cnt > 0 ? now - requests[0].arrival_timestamp : 0;
+    disk_queue_destroy(dq);
+    return 0;
+}
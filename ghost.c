@@ -0,0 +1,432 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "oslabs.h"
+
+/*Scan-resistant policies that remember pages after evicting them. A page referenced once, like every
+page of a long sequential scan, only reaches a short probationary list and leaves memory from there,
+so it cannot push out the pages that are referenced again and again. The evicted pages stay on "ghost"
+lists of page numbers without frames. A fault on a ghost shows that the page was evicted too early,
+and each policy counts those faults so a run can show how often its scan resistance got it wrong.
+
+ARC (Megiddo and Modha, FAST 2003) splits memory between t1, pages referenced once since they came in,
+and t2, pages referenced at least twice, with ghost lists b1 and b2 for each. A fault on a b1 ghost
+moves the target size of t1 up, a fault on a b2 ghost moves it down, so the split follows the trace.
+
+2Q (Johnson and Shasha, VLDB 1994) loads new pages into the FIFO a1in. Pages pushed out of a1in are
+remembered on a1out, and only a page referenced again while on a1out enters am, the main LRU list.
+
+All the lists of a policy share one pair of link arrays, since a page is on at most one of them.*/
+
+#define ARC_NONE 0
+#define ARC_T1 1
+#define ARC_T2 2
+#define ARC_B1 3
+#define ARC_B2 4
+#define TWO_QUEUE_NONE 0
+#define TWO_QUEUE_A1IN 1
+#define TWO_QUEUE_A1OUT 2
+#define TWO_QUEUE_AM 3
+#define TWO_QUEUE_IN_PERCENT 25 //share of the frames a1in may hold before it gives up pages
+#define TWO_QUEUE_OUT_PERCENT 50 //ghosts a1out remembers, as a share of the frames
+
+static void list_clear(struct LRU_LIST *list, int prev[], int next[])
+{
+    list->prev = prev;
+    list->next = next;
+    list->head = -1;
+    list->tail = -1;
+    list->size = 0;
+    list->rank = NULL;
+}
+
+static int page_out(struct PTE page_table[], int page_number)
+{
+    //marks the page as not in memory and returns the frame it held
+    struct PTE *entry = &page_table[page_number];
+    int frame_number = entry->frame_number;
+
+    entry->frame_number = -1;
+    entry->is_valid = 0;
+    entry->arrival_timestamp = -1;
+    entry->last_access_timestamp = -1;
+    entry->reference_count = -1;
+    entry->reference_bit = 0;
+    return frame_number;
+}
+
+static void page_in(struct PTE *entry, int frame_number, int current_timestamp, int prefetch)
+{
+    //a prefetched page has not been referenced yet
+    entry->frame_number = frame_number;
+    entry->is_valid = 1;
+    entry->arrival_timestamp = current_timestamp;
+    entry->last_access_timestamp = current_timestamp;
+    entry->reference_count = prefetch ? 0 : 1;
+    entry->reference_bit = 1;
+}
+
+static void page_hit(struct PTE *entry, int current_timestamp)
+{
+    entry->reference_count += 1; //update reference count
+    entry->reference_bit = 1;
+    entry->last_access_timestamp = current_timestamp; //update time
+}
+
+static int seed_resident(struct LRU_LIST *list,
+int prev[],
+int next[],
+int where[],
+int resident,
+struct PTE page_table[],
+int table_cnt)
+{
+    //links the pages already in memory onto list in last_access_timestamp order, all others on no list
+    if(lru_list_init(list, prev, next, page_table, table_cnt) != 0){
+        return -1;
+    }
+    for(int i = 0; i < table_cnt; i++){
+        where[i] = page_table[i].is_valid != 0 ? resident : 0;
+    }
+    return 0;
+}
+
+int arc_init(struct ARC *arc,
+int prev[],
+int next[],
+int list[],
+struct PTE page_table[],
+int table_cnt,
+int frame_cnt)
+{
+    /*Puts every page already in memory on t1, least recently used first, with empty ghost lists. ARC
+manages as many frames as there are pages in memory plus frame_cnt free ones. The prev, next and list
+arrays must hold table_cnt entries each.
+Returns 0 on success and -1 if the temporary sort buffer cannot be allocated.*/
+    if(seed_resident(&arc->t1, prev, next, list, ARC_T1, page_table, table_cnt) != 0){
+        return -1;
+    }
+    list_clear(&arc->t2, prev, next);
+    list_clear(&arc->b1, prev, next);
+    list_clear(&arc->b2, prev, next);
+    arc->list = list;
+    arc->target = 0;
+    arc->frames = arc->t1.size + frame_cnt;
+    arc->evicted_page = -1;
+    arc->evictions = 0;
+    arc->b1_hits = 0;
+    arc->b2_hits = 0;
+    return 0;
+}
+
+static void arc_move(struct ARC *arc, int page_number, int to)
+{
+    //unlinks the page from its list, if any, and appends it to the most recent end of list to
+    struct LRU_LIST *lists[5] = { NULL, &arc->t1, &arc->t2, &arc->b1, &arc->b2 };
+
+    if(arc->list[page_number] != ARC_NONE){
+        lru_list_unlink(lists[arc->list[page_number]], page_number);
+    }
+    arc->list[page_number] = to;
+    if(to != ARC_NONE){
+        lru_list_push(lists[to], page_number);
+    }
+}
+
+static int arc_replace(struct ARC *arc, struct PTE page_table[], int in_b2)
+{
+    /*Evicts the least recently used page of t1 onto b1 if t1 is over its target, otherwise that of t2
+onto b2, and returns the freed frame. A fault on a b2 ghost also takes from t1 when t1 is exactly at
+its target.*/
+    int victim;
+
+    if(arc->t1.size > 0 && (arc->t1.size > arc->target || (in_b2 && arc->t1.size == arc->target) || arc->t2.size == 0)){
+        victim = arc->t1.head;
+        arc_move(arc, victim, ARC_B1);
+    }
+    else {
+        victim = arc->t2.head;
+        arc_move(arc, victim, ARC_B2);
+    }
+    arc->evicted_page = victim;
+    arc->evictions += 1;
+    return page_out(page_table, victim);
+}
+
+static int arc_load(struct ARC *arc,
+struct PTE page_table[],
+int page_number,
+int frame_pool[],
+int *frame_cnt,
+int current_timestamp,
+int prefetch)
+{
+    /*Brings a page that is not in memory in. A prefetch is no sign that the page left memory too
+early, so a ghost of it is forgotten instead of adapting the target, and the page goes on t1 with a
+reference_count of 0.*/
+    struct PTE *entry = &page_table[page_number];
+    int where = arc->list[page_number];
+    int frame_number;
+
+    if(arc->frames == 0){
+        return -1;
+    }
+    if(prefetch && (where == ARC_B1 || where == ARC_B2)){
+        arc_move(arc, page_number, ARC_NONE);
+        where = ARC_NONE;
+    }
+    if(where == ARC_B1){
+        arc->target = MIN(arc->frames, arc->target + MAX(arc->b2.size / arc->b1.size, 1));
+        arc->b1_hits += 1;
+    }
+    else if(where == ARC_B2){
+        arc->target = MAX(0, arc->target - MAX(arc->b1.size / arc->b2.size, 1));
+        arc->b2_hits += 1;
+    }
+    else if(arc->t1.size + arc->b1.size == arc->frames){
+        if(arc->t1.size < arc->frames){
+            arc_move(arc, arc->b1.head, ARC_NONE); //forget the oldest ghost of a page seen once
+        }
+        else {
+            int victim = arc->t1.head; //t1 holds every frame, drop its oldest page without a ghost
+
+            arc_move(arc, victim, ARC_NONE);
+            arc->evicted_page = victim;
+            arc->evictions += 1;
+            frame_number = page_out(page_table, victim);
+            page_in(entry, frame_number, current_timestamp, prefetch);
+            arc_move(arc, page_number, ARC_T1);
+            return frame_number;
+        }
+    }
+    else if(arc->t1.size + arc->t2.size + arc->b1.size + arc->b2.size == 2 * arc->frames){
+        arc_move(arc, arc->b2.head, ARC_NONE); //forget the oldest ghost of a frequent page
+    }
+    if(*frame_cnt > 0){
+        *frame_cnt -= 1; //lowers frame count
+        frame_number = frame_pool[*frame_cnt];
+    }
+    else {
+        frame_number = arc_replace(arc, page_table, where == ARC_B2);
+    }
+    page_in(entry, frame_number, current_timestamp, prefetch);
+    arc_move(arc, page_number, where == ARC_B1 || where == ARC_B2 ? ARC_T2 : ARC_T1);
+    return frame_number;
+}
+
+int arc_access(struct ARC *arc,
+struct PTE page_table[],
+int page_number,
+int frame_pool[],
+int *frame_cnt,
+int current_timestamp)
+{
+    /*Returns the frame number of the logical page, loading it if needed. A hit moves the page to the
+most recent end of t2, or of t1 if it is the first reference to a prefetched page. A fault on a ghost
+adapts the target size of t1 and loads the page onto t2, any other fault loads it onto t1. Free frames
+in the pool are used before anything is evicted, and ghosts beyond what ARC remembers (frames pages on
+t1 and b1, twice that on all four lists) are forgotten. arc->evicted_page is the page this access
+moved out of memory, or -1. Returns -1 if ARC has no frames at all.*/
+    struct PTE *entry = &page_table[page_number];
+
+    arc->evicted_page = -1;
+    if(entry->is_valid != 0){
+        int first = entry->reference_count == 0;
+
+        page_hit(entry, current_timestamp);
+        arc_move(arc, page_number, first ? ARC_T1 : ARC_T2);
+        return entry->frame_number;
+    }
+    return arc_load(arc, page_table, page_number, frame_pool, frame_cnt, current_timestamp, 0);
+}
+
+int arc_prefetch(struct ARC *arc,
+struct PTE page_table[],
+int page_number,
+int frame_pool[],
+int *frame_cnt,
+int current_timestamp)
+{
+    /*Loads the page ahead of its first reference onto t1, replacing like a fault but without counting
+or adapting to a ghost of the page. A page already in memory is left alone. Returns the frame number,
+or -1 if ARC has no frames at all.*/
+    arc->evicted_page = -1;
+    if(page_table[page_number].is_valid != 0){
+        return page_table[page_number].frame_number;
+    }
+    return arc_load(arc, page_table, page_number, frame_pool, frame_cnt, current_timestamp, 1);
+}
+
+int two_queue_init(struct TWO_QUEUE *tq,
+int prev[],
+int next[],
+int list[],
+struct PTE page_table[],
+int table_cnt,
+int frame_cnt)
+{
+    /*Puts every page already in memory on am, least recently used first, with a1in and a1out empty.
+a1in may hold TWO_QUEUE_IN_PERCENT and a1out TWO_QUEUE_OUT_PERCENT of the frames in memory plus
+frame_cnt free ones, at least one page each. The prev, next and list arrays must hold table_cnt
+entries each.
+Returns 0 on success and -1 if the temporary sort buffer cannot be allocated.*/
+    if(seed_resident(&tq->am, prev, next, list, TWO_QUEUE_AM, page_table, table_cnt) != 0){
+        return -1;
+    }
+    list_clear(&tq->a1in, prev, next);
+    list_clear(&tq->a1out, prev, next);
+    tq->list = list;
+    tq->frames = tq->am.size + frame_cnt;
+    tq->in_max = MAX(1, (int)((long long)tq->frames * TWO_QUEUE_IN_PERCENT / 100));
+    tq->out_max = MAX(1, (int)((long long)tq->frames * TWO_QUEUE_OUT_PERCENT / 100));
+    tq->evicted_page = -1;
+    tq->evictions = 0;
+    tq->a1out_hits = 0;
+    return 0;
+}
+
+static void two_queue_move(struct TWO_QUEUE *tq, int page_number, int to)
+{
+    //unlinks the page from its list, if any, and appends it to the tail of list to
+    struct LRU_LIST *lists[4] = { NULL, &tq->a1in, &tq->a1out, &tq->am };
+
+    if(tq->list[page_number] != TWO_QUEUE_NONE){
+        lru_list_unlink(lists[tq->list[page_number]], page_number);
+    }
+    tq->list[page_number] = to;
+    if(to != TWO_QUEUE_NONE){
+        lru_list_push(lists[to], page_number);
+    }
+}
+
+static int two_queue_load(struct TWO_QUEUE *tq,
+struct PTE page_table[],
+int page_number,
+int frame_pool[],
+int *frame_cnt,
+int current_timestamp,
+int prefetch)
+{
+    /*Brings a page that is not in memory in. A prefetch is not a second reference, so a ghost of it on
+a1out is forgotten without being counted and the page goes on a1in with a reference_count of 0.*/
+    struct PTE *entry = &page_table[page_number];
+    int ghost = tq->list[page_number] == TWO_QUEUE_A1OUT;
+    int frame_number;
+    int victim;
+
+    if(tq->frames == 0){
+        return -1;
+    }
+    if(ghost){
+        tq->a1out_hits += !prefetch;
+        two_queue_move(tq, page_number, TWO_QUEUE_NONE);
+        ghost = !prefetch;
+    }
+    if(*frame_cnt > 0){
+        *frame_cnt -= 1; //lowers frame count
+        frame_number = frame_pool[*frame_cnt];
+    }
+    else {
+        if(tq->a1in.size > tq->in_max || tq->am.size == 0){
+            victim = tq->a1in.head;
+            two_queue_move(tq, victim, TWO_QUEUE_A1OUT);
+            if(tq->a1out.size > tq->out_max){
+                two_queue_move(tq, tq->a1out.head, TWO_QUEUE_NONE); //forget the oldest ghost
+            }
+        }
+        else {
+            victim = tq->am.head;
+            two_queue_move(tq, victim, TWO_QUEUE_NONE);
+        }
+        tq->evicted_page = victim;
+        tq->evictions += 1;
+        frame_number = page_out(page_table, victim);
+    }
+    page_in(entry, frame_number, current_timestamp, prefetch);
+    two_queue_move(tq, page_number, ghost ? TWO_QUEUE_AM : TWO_QUEUE_A1IN);
+    return frame_number;
+}
+
+int two_queue_access(struct TWO_QUEUE *tq,
+struct PTE page_table[],
+int page_number,
+int frame_pool[],
+int *frame_cnt,
+int current_timestamp)
+{
+    /*Returns the frame number of the logical page, loading it if needed. A hit on am moves the page to
+its most recently used end and a hit on a1in leaves it in place. A fault on an a1out ghost loads the
+page onto am, any other fault onto a1in. Without a free frame, the head of a1in leaves memory onto
+a1out when a1in is over its share (or am is empty), otherwise the least recently used page of am is
+evicted and forgotten. tq->evicted_page is the page this access moved out of memory, or -1. Returns
+-1 if 2Q has no frames at all.*/
+    struct PTE *entry = &page_table[page_number];
+
+    tq->evicted_page = -1;
+    if(entry->is_valid != 0){
+        page_hit(entry, current_timestamp);
+        if(tq->list[page_number] == TWO_QUEUE_AM){
+            two_queue_move(tq, page_number, TWO_QUEUE_AM);
+        }
+        return entry->frame_number;
+    }
+    return two_queue_load(tq, page_table, page_number, frame_pool, frame_cnt, current_timestamp, 0);
+}
+
+int two_queue_prefetch(struct TWO_QUEUE *tq,
+struct PTE page_table[],
+int page_number,
+int frame_pool[],
+int *frame_cnt,
+int current_timestamp)
+{
+    /*Loads the page ahead of its first reference onto a1in, replacing like a fault but without counting
+a ghost of the page. A page already in memory is left alone. Returns the frame number, or -1 if 2Q has
+no frames at all.*/
+    tq->evicted_page = -1;
+    if(page_table[page_number].is_valid != 0){
+        return page_table[page_number].frame_number;
+    }
+    return two_queue_load(tq, page_table, page_number, frame_pool, frame_cnt, current_timestamp, 1);
+}
+
+int count_page_faults_arc(struct PTE page_table[],
+int table_cnt,
+int reference_string[],
+int reference_cnt,
+int frame_pool[],
+int frame_cnt)
+{
+    /*Returns the number of page faults for the reference string under ARC replacement, starting with a
+timestamp of 1 and incrementing it for every page access. Like CLOCK-Pro, ARC keeps state between
+accesses that the page table cannot hold, so single accesses go through a PAGE_CONTEXT, which also
+counts the faults on ghosts. Returns -1 if the context cannot be allocated or the reference string
+names a page outside the page table.*/
+    struct PAGE_CONTEXT *ctx = page_context_attach(page_table, table_cnt, frame_pool, frame_cnt, POLICY_ARC);
+    int page_fault_counter;
+
+    if(ctx == NULL){
+        return -1;
+    }
+    page_fault_counter = page_context_run(ctx, reference_string, reference_cnt);
+    page_context_destroy(ctx);
+    return page_fault_counter;
+}
+
+int count_page_faults_2q(struct PTE page_table[],
+int table_cnt,
+int reference_string[],
+int reference_cnt,
+int frame_pool[],
+int frame_cnt)
+{
+    //same as count_page_faults_arc under 2Q replacement
+    struct PAGE_CONTEXT *ctx = page_context_attach(page_table, table_cnt, frame_pool, frame_cnt, POLICY_2Q);
+    int page_fault_counter;
+
+    if(ctx == NULL){
+        return -1;
+    }
+    page_fault_counter = page_context_run(ctx, reference_string, reference_cnt);
+    page_context_destroy(ctx);
+    return page_fault_counter;
+}
@@ -0,0 +1,325 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include "oslabs.h"
+
+/*Instrumentation of the page_context_access hot path, built only with OSLABS_INSTRUMENT defined (the
+OSLABS_INSTRUMENT CMake option). Without it the INSTRUMENT_ hooks in context.c expand to nothing, the
+contexts allocate no shadow arrays, and everything here reports that it is not built in.
+
+Each thread records into its own block of counters, so the hot path takes no lock and shares no cache
+line. A block is linked into a global list the first time its thread records anything, and
+instrument_snapshot adds the blocks up. Blocks live until the program exits, so the counts of threads
+that have finished, such as sweep_run's workers, are still there.
+
+Eviction age is the time from a page's load to its eviction and reuse distance the time since its
+previous reference, both in timestamps and in log2 buckets. Contexts keep the timestamps they need in
+two shadow arrays, which survive the page leaving memory, so a fault on a page that was evicted still
+gets its reuse distance. Views have no shadow arrays. They fall back on the page table, which gives the
+age of an eviction but no reuse distance.
+
+The event log gives every thread a ring of capacity events. A full ring is written to the log file
+under a lock in one fwrite, and instrument_log_close writes what is left. Events are the raw
+INSTRUMENT_EVENT structs in the machine's byte order. Open the log before starting threads that record
+and close it after they finish.*/
+
+#ifdef OSLABS_INSTRUMENT
+
+struct INSTRUMENT_THREAD {
+    struct INSTRUMENT_COUNTERS counters;
+    struct INSTRUMENT_EVENT *ring;
+    int ring_cnt;
+    int ring_cap;
+    int thread_id;
+    long long run_start;
+    struct INSTRUMENT_THREAD *next;
+};
+
+static pthread_mutex_t instrument_lock = PTHREAD_MUTEX_INITIALIZER;
+static struct INSTRUMENT_THREAD *instrument_threads;
+static int instrument_thread_cnt;
+static FILE *log_file;
+static int log_capacity;
+static long long log_events; //events written since the log was opened
+static _Thread_local struct INSTRUMENT_THREAD *current_thread;
+
+static struct INSTRUMENT_THREAD *instrument_thread(void)
+{
+    //this thread's block, registered on first use, NULL if it cannot be allocated
+    struct INSTRUMENT_THREAD *thread = current_thread;
+
+    if(thread == NULL){
+        thread = calloc(1, sizeof(struct INSTRUMENT_THREAD));
+        if(thread == NULL){
+            return NULL;
+        }
+        pthread_mutex_lock(&instrument_lock);
+        thread->thread_id = instrument_thread_cnt++;
+        thread->next = instrument_threads;
+        instrument_threads = thread;
+        pthread_mutex_unlock(&instrument_lock);
+        current_thread = thread;
+    }
+    return thread;
+}
+
+static int instrument_bucket(long long value)
+{
+    if(value <= 0){
+        return 0;
+    }
+#if defined(__GNUC__)
+    return MIN(INSTRUMENT_BUCKETS - 1, 64 - __builtin_clzll((unsigned long long)value));
+#else
+    {
+        int bucket = 0;
+
+        while(value > 0 && bucket < INSTRUMENT_BUCKETS - 1){
+            value >>= 1;
+            bucket++;
+        }
+        return bucket;
+    }
+#endif
+}
+
+static void ring_write(struct INSTRUMENT_THREAD *thread)
+{
+    //writes the thread's ring to the log, the caller holds instrument_lock
+    size_t written = 0;
+
+    if(log_file != NULL && thread->ring_cnt > 0){
+        written = fwrite(thread->ring, sizeof(struct INSTRUMENT_EVENT), (size_t)thread->ring_cnt, log_file);
+    }
+    thread->counters.events += (long long)written;
+    thread->counters.dropped_events += thread->ring_cnt - (long long)written;
+    log_events += (long long)written;
+    thread->ring_cnt = 0;
+}
+
+static void instrument_log(struct INSTRUMENT_THREAD *thread, int type, int timestamp, int page_number, int frame_number, long long value)
+{
+    struct INSTRUMENT_EVENT *event;
+
+    if(log_file == NULL){
+        return;
+    }
+    if(thread->ring_cap != log_capacity){
+        free(thread->ring); //empty, the last close wrote it out
+        thread->ring = malloc((size_t)log_capacity * sizeof(struct INSTRUMENT_EVENT));
+        thread->ring_cap = thread->ring != NULL ? log_capacity : 0;
+        thread->ring_cnt = 0;
+        if(thread->ring == NULL){
+            thread->counters.dropped_events += 1;
+            return;
+        }
+    }
+    event = &thread->ring[thread->ring_cnt++];
+    event->type = type;
+    event->thread_id = thread->thread_id;
+    event->timestamp = timestamp;
+    event->page_number = page_number;
+    event->frame_number = frame_number;
+    event->value = (int)MIN(value, 2147483647LL);
+    if(thread->ring_cnt == thread->ring_cap){
+        pthread_mutex_lock(&instrument_lock);
+        ring_write(thread);
+        pthread_mutex_unlock(&instrument_lock);
+    }
+}
+
+void instrument_access(struct PAGE_CONTEXT *ctx, int page_number, int frame_number, int hit, int prefetch, int current_timestamp)
+{
+    /*Records a completed access of page_number through ctx. A failed access, with frame_number -1, is
+not recorded. A prefetch, which always loads the page, is counted apart from the faults and is not a
+reference, so it starts the page's eviction age but not a reuse distance.*/
+    struct INSTRUMENT_THREAD *thread = instrument_thread();
+    long long reuse = -1;
+
+    if(thread == NULL || frame_number == -1){
+        return;
+    }
+    if(prefetch){
+        if(ctx->loaded_at != NULL){
+            ctx->loaded_at[page_number] = current_timestamp;
+        }
+        thread->counters.prefetches += 1;
+        instrument_log(thread, INSTRUMENT_EVENT_PREFETCH, current_timestamp, page_number, frame_number, -1);
+        return;
+    }
+    if(ctx->last_reference != NULL){
+        if(ctx->last_reference[page_number] != -1 && ctx->last_reference[page_number] <= current_timestamp){
+            reuse = (long long)current_timestamp - ctx->last_reference[page_number];
+        }
+        ctx->last_reference[page_number] = current_timestamp;
+        if(!hit){
+            ctx->loaded_at[page_number] = current_timestamp;
+        }
+    }
+    if(hit){
+        thread->counters.hits += 1;
+    }
+    else {
+        thread->counters.faults += 1;
+    }
+    if(reuse != -1){
+        thread->counters.reuse_distance[instrument_bucket(reuse)] += 1;
+    }
+    instrument_log(thread, hit ? INSTRUMENT_EVENT_HIT : INSTRUMENT_EVENT_FAULT, current_timestamp, page_number, frame_number, reuse);
+}
+
+void instrument_evict(struct PAGE_CONTEXT *ctx, int page_number, int current_timestamp)
+{
+    //records page_number leaving memory, before or after its entry is cleared
+    struct INSTRUMENT_THREAD *thread = instrument_thread();
+    long long loaded = -1;
+    long long age = -1;
+
+    if(thread == NULL){
+        return;
+    }
+    loaded = ctx->loaded_at != NULL ? ctx->loaded_at[page_number] : -1;
+    if(loaded == -1){
+        loaded = ctx->page_table[page_number].arrival_timestamp; //a view, or a page loaded before attach
+    }
+    if(loaded != -1 && loaded <= current_timestamp){
+        age = current_timestamp - loaded;
+        thread->counters.eviction_age[instrument_bucket(age)] += 1;
+    }
+    thread->counters.evictions += 1;
+    instrument_log(thread, INSTRUMENT_EVENT_EVICT, current_timestamp, page_number, -1, age);
+}
+
+void instrument_run_begin(void)
+{
+    struct INSTRUMENT_THREAD *thread = instrument_thread();
+
+    if(thread != NULL){
+        thread->run_start = monotonic_ns();
+    }
+}
+
+void instrument_run_end(int reference_cnt)
+{
+    struct INSTRUMENT_THREAD *thread = instrument_thread();
+
+    if(thread != NULL){
+        thread->counters.runs += 1;
+        thread->counters.run_references += reference_cnt;
+        thread->counters.run_ns += monotonic_ns() - thread->run_start;
+    }
+}
+
+int instrument_snapshot(struct INSTRUMENT_COUNTERS *total)
+{
+    /*Adds up the counters of every thread that has recorded anything into total and returns the number
+of such threads. Counts of threads still running may be a few accesses behind.*/
+    int thread_cnt;
+
+    memset(total, 0, sizeof(struct INSTRUMENT_COUNTERS));
+    pthread_mutex_lock(&instrument_lock);
+    for(struct INSTRUMENT_THREAD *thread = instrument_threads; thread != NULL; thread = thread->next){
+        struct INSTRUMENT_COUNTERS *counters = &thread->counters;
+
+        total->hits += counters->hits;
+        total->faults += counters->faults;
+        total->prefetches += counters->prefetches;
+        total->evictions += counters->evictions;
+        for(int b = 0; b < INSTRUMENT_BUCKETS; b++){
+            total->eviction_age[b] += counters->eviction_age[b];
+            total->reuse_distance[b] += counters->reuse_distance[b];
+        }
+        total->runs += counters->runs;
+        total->run_references += counters->run_references;
+        total->run_ns += counters->run_ns;
+        total->events += counters->events;
+        total->dropped_events += counters->dropped_events;
+    }
+    thread_cnt = instrument_thread_cnt;
+    pthread_mutex_unlock(&instrument_lock);
+    return thread_cnt;
+}
+
+void instrument_reset(void)
+{
+    //starts every thread's counters over, call it while no thread is recording
+    pthread_mutex_lock(&instrument_lock);
+    for(struct INSTRUMENT_THREAD *thread = instrument_threads; thread != NULL; thread = thread->next){
+        memset(&thread->counters, 0, sizeof(struct INSTRUMENT_COUNTERS));
+    }
+    pthread_mutex_unlock(&instrument_lock);
+}
+
+int instrument_log_open(const char *path, int capacity)
+{
+    /*Starts logging every event to the file at path, which is truncated, through rings of capacity
+events per thread. Returns -1 if capacity is not positive, a log is already open or the file cannot be
+opened.*/
+    int status = -1;
+
+    if(capacity <= 0){
+        return -1;
+    }
+    pthread_mutex_lock(&instrument_lock);
+    if(log_file == NULL){
+        log_file = fopen(path, "wb");
+        if(log_file != NULL){
+            log_capacity = capacity;
+            log_events = 0;
+            status = 0;
+        }
+    }
+    pthread_mutex_unlock(&instrument_lock);
+    return status;
+}
+
+long long instrument_log_close(void)
+{
+    /*Writes out every thread's ring and closes the log. Returns the number of events written since it
+was opened, or -1 if no log is open or the file could not be written.*/
+    long long events;
+    int failed;
+
+    pthread_mutex_lock(&instrument_lock);
+    if(log_file == NULL){
+        pthread_mutex_unlock(&instrument_lock);
+        return -1;
+    }
+    for(struct INSTRUMENT_THREAD *thread = instrument_threads; thread != NULL; thread = thread->next){
+        ring_write(thread);
+    }
+    failed = ferror(log_file) != 0;
+    failed |= fclose(log_file) != 0;
+    log_file = NULL;
+    events = log_events;
+    pthread_mutex_unlock(&instrument_lock);
+    return failed ? -1 : events;
+}
+
+#else
+
+int instrument_snapshot(struct INSTRUMENT_COUNTERS *total)
+{
+    //not built in: total is all zeros
+    memset(total, 0, sizeof(struct INSTRUMENT_COUNTERS));
+    return -1;
+}
+
+void instrument_reset(void)
+{
+}
+
+int instrument_log_open(const char *path, int capacity)
+{
+    (void)path;
+    (void)capacity;
+    return -1;
+}
+
+long long instrument_log_close(void)
+{
+    return -1;
+}
+
+#endif
@@ -0,0 +1,319 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <limits.h>
+#include "oslabs.h"
+
+/*A MEMORY_MANAGER models a whole machine: many processes, each with its own page table, sharing one
+pool of frames. All the page tables sit one after the other in a single PTE array, so a page is known
+by one global index (the process's base plus its page number) and the FIFO, LRU and CLOCK list engines
+work on it unchanged.
+
+Under global replacement every page in memory is on one list and a fault may take a frame from any
+process. Under local replacement each process has its own list and a quota of frames. A fault takes a
+free frame while the process is under its quota and replaces one of the process's own pages once it is
+at it. Quotas never add up to more than the pool, so a process under its quota always finds a free
+frame.
+
+Everything lives in one arena, and a process costs one PROCESS_MEMORY plus its page table, so
+thousands of processes are cheap. Finding which process a page belongs to is a binary search over the
+bases.*/
+
+static int valid_scope_policy(int policy, int scope)
+{
+    return (policy == POLICY_FIFO || policy == POLICY_LRU || policy == POLICY_CLOCK)
+        && (scope == SCOPE_GLOBAL || scope == SCOPE_LOCAL);
+}
+
+static int page_owner(struct MEMORY_MANAGER *mm, int index)
+{
+    //process whose page table holds the global index
+    int low = 0;
+    int high = mm->process_cnt - 1;
+
+    while(low < high){
+        int middle = low + (high - low + 1) / 2;
+        if(mm->processes[middle].base <= index){
+            low = middle;
+        }
+        else {
+            high = middle - 1;
+        }
+    }
+    return low;
+}
+
+static int list_victim(struct MEMORY_MANAGER *mm, struct LRU_LIST *list, int current_timestamp)
+{
+    //the page the next fault on list replaces, -1 if the list is empty
+    if(mm->policy == POLICY_CLOCK){
+        return clock_list_victim(list, mm->page_table, current_timestamp);
+    }
+    return list->head;
+}
+
+static int list_access(struct MEMORY_MANAGER *mm, struct LRU_LIST *list, int index, int *frame_cnt, int current_timestamp)
+{
+    switch(mm->policy){
+    case POLICY_FIFO:
+        return fifo_list_access(list, mm->page_table, index, mm->frame_pool, frame_cnt, current_timestamp);
+    case POLICY_LRU:
+        return lru_list_access(list, mm->page_table, index, mm->frame_pool, frame_cnt, current_timestamp);
+    }
+    return clock_list_access(list, mm->page_table, index, mm->frame_pool, frame_cnt, current_timestamp);
+}
+
+static void manager_clear(struct MEMORY_MANAGER *mm)
+{
+    //every page out of memory, every frame free and every counter at zero
+    for(int i = 0; i < mm->page_cnt; i++){
+        mm->page_table[i].is_valid = 0;
+        mm->page_table[i].frame_number = -1;
+        mm->page_table[i].arrival_timestamp = -1;
+        mm->page_table[i].last_access_timestamp = -1;
+        mm->page_table[i].reference_count = -1;
+        mm->page_table[i].reference_bit = 0;
+    }
+    for(int i = 0; i < mm->pool_cnt; i++){
+        mm->frame_pool[i] = i;
+    }
+    mm->frame_cnt = mm->pool_cnt;
+    mm->timestamp = 1;
+    mm->page_faults = 0;
+    mm->page_hits = 0;
+    mm->evictions = 0;
+    mm->list.head = -1;
+    mm->list.tail = -1;
+    mm->list.size = 0;
+    mm->list.rank = NULL;
+    for(int pid = 0; pid < mm->process_cnt; pid++){
+        struct PROCESS_MEMORY *process = &mm->processes[pid];
+
+        process->resident = 0;
+        process->page_faults = 0;
+        process->page_hits = 0;
+        process->evictions = 0;
+        process->list.prev = mm->list.prev; //a page is only ever on its own process's list, so they share links
+        process->list.next = mm->list.next;
+        process->list.head = -1;
+        process->list.tail = -1;
+        process->list.size = 0;
+        process->list.rank = NULL;
+    }
+}
+
+struct MEMORY_MANAGER *memory_manager_create(int process_cnt,
+int table_cnts[],
+int pool_cnt,
+int policy,
+int scope)
+{
+    /*Creates a manager for process_cnt processes, where process i has a page table of table_cnts[i]
+entries, all invalid, and a shared pool of frames 0 to pool_cnt - 1. policy is POLICY_FIFO,
+POLICY_LRU or POLICY_CLOCK and scope is SCOPE_GLOBAL or SCOPE_LOCAL. Each process starts with an
+equal share of the frames as its quota, the first processes getting one more when they do not divide
+evenly. Returns NULL if an argument is invalid, the page tables add up to more than INT_MAX entries or
+the arena cannot be allocated.*/
+    struct ARENA arena;
+    struct MEMORY_MANAGER *mm;
+    long long page_cnt = 0;
+    size_t pages;
+
+    if(process_cnt <= 0 || pool_cnt < 0 || !valid_scope_policy(policy, scope)){
+        return NULL;
+    }
+    for(int pid = 0; pid < process_cnt; pid++){
+        if(table_cnts[pid] <= 0){
+            return NULL;
+        }
+        page_cnt += table_cnts[pid];
+    }
+    if(page_cnt > 2147483647LL){
+        return NULL;
+    }
+    pages = (size_t)page_cnt;
+    arena.base = malloc(arena_size(sizeof(struct MEMORY_MANAGER))
+        + arena_size((size_t)process_cnt * sizeof(struct PROCESS_MEMORY))
+        + arena_size(pages * sizeof(struct PTE))
+        + 2 * arena_size(pages * sizeof(int))
+        + arena_size((size_t)pool_cnt * sizeof(int)));
+    arena.used = 0;
+    if(arena.base == NULL){
+        return NULL;
+    }
+    mm = arena_take(&arena, sizeof(struct MEMORY_MANAGER));
+    mm->arena = arena.base;
+    mm->policy = policy;
+    mm->scope = scope;
+    mm->process_cnt = process_cnt;
+    mm->page_cnt = (int)page_cnt;
+    mm->pool_cnt = pool_cnt;
+    mm->processes = arena_take(&arena, (size_t)process_cnt * sizeof(struct PROCESS_MEMORY));
+    mm->page_table = arena_take(&arena, pages * sizeof(struct PTE));
+    mm->list.prev = arena_take(&arena, pages * sizeof(int));
+    mm->list.next = arena_take(&arena, pages * sizeof(int));
+    mm->frame_pool = arena_take(&arena, (size_t)pool_cnt * sizeof(int));
+    page_cnt = 0;
+    for(int pid = 0; pid < process_cnt; pid++){
+        mm->processes[pid].base = (int)page_cnt;
+        mm->processes[pid].table_cnt = table_cnts[pid];
+        mm->processes[pid].quota = pool_cnt / process_cnt + (pid < pool_cnt % process_cnt);
+        page_cnt += table_cnts[pid];
+    }
+    manager_clear(mm);
+    return mm;
+}
+
+void memory_manager_destroy(struct MEMORY_MANAGER *mm)
+{
+    if(mm != NULL){
+        free(mm->arena); //the manager itself lives in the arena
+    }
+}
+
+void memory_manager_reset(struct MEMORY_MANAGER *mm)
+{
+    /*Starts a new simulation: every page leaves memory, the pool is full again and all counters and the
+timestamp start over. Quotas are kept.*/
+    manager_clear(mm);
+}
+
+int memory_manager_set_quota(struct MEMORY_MANAGER *mm, int process_id, int quota)
+{
+    /*Sets the number of frames the process may hold under local replacement. If it holds more, its
+pages leave memory in replacement order until it fits, and their frames go back to the pool. Returns
+-1 if the process does not exist, quota is negative or the quotas would add up to more than the pool.*/
+    struct PROCESS_MEMORY *process;
+    long long total = quota;
+
+    if(process_id < 0 || process_id >= mm->process_cnt || quota < 0){
+        return -1;
+    }
+    for(int pid = 0; pid < mm->process_cnt; pid++){
+        if(pid != process_id){
+            total += mm->processes[pid].quota;
+        }
+    }
+    if(total > mm->pool_cnt){
+        return -1;
+    }
+    process = &mm->processes[process_id];
+    process->quota = quota;
+    while(mm->scope == SCOPE_LOCAL && process->resident > quota){
+        int victim = list_victim(mm, &process->list, mm->timestamp);
+        struct PTE *entry = &mm->page_table[victim];
+
+        lru_list_unlink(&process->list, victim);
+        mm->frame_pool[mm->frame_cnt++] = entry->frame_number; //back to the pool
+        entry->frame_number = -1;
+        entry->is_valid = 0;
+        entry->arrival_timestamp = -1;
+        entry->last_access_timestamp = -1;
+        entry->reference_count = -1;
+        entry->reference_bit = 0;
+        process->resident -= 1;
+        process->evictions += 1;
+        mm->evictions += 1;
+    }
+    return 0;
+}
+
+int memory_manager_access(struct MEMORY_MANAGER *mm, int process_id, int page_number, int current_timestamp)
+{
+    /*Returns the frame number of a page of a process, loading it if needed, with the same page-table
+updates as process_page_access_fifo, _lru or _clock. Under global replacement the page replaced may
+belong to any process. Under local replacement it is one of the process's own pages once the process
+holds its quota. Returns -1 if the process or page does not exist or there is neither a free frame nor
+a page to replace, for example a process with a quota of 0 under local replacement.*/
+    struct PROCESS_MEMORY *process;
+    struct LRU_LIST *list;
+    int index;
+    int free_cnt;
+    int victim = -1;
+    int frame_number;
+
+    if(process_id < 0 || process_id >= mm->process_cnt){
+        return -1;
+    }
+    process = &mm->processes[process_id];
+    if(page_number < 0 || page_number >= process->table_cnt){
+        return -1;
+    }
+    index = process->base + page_number;
+    list = mm->scope == SCOPE_GLOBAL ? &mm->list : &process->list;
+    if(mm->page_table[index].is_valid != 0){
+        process->page_hits += 1;
+        mm->page_hits += 1;
+        free_cnt = 0;
+        return list_access(mm, list, index, &free_cnt, current_timestamp);
+    }
+    free_cnt = mm->frame_cnt;
+    if(mm->scope == SCOPE_LOCAL && process->resident >= process->quota){
+        free_cnt = 0; //at its quota, it replaces its own pages
+    }
+    if(free_cnt == 0){
+        victim = list_victim(mm, list, current_timestamp);
+        if(victim == -1){
+            return -1;
+        }
+    }
+    frame_number = list_access(mm, list, index, &free_cnt, current_timestamp);
+    if(victim == -1){
+        mm->frame_cnt -= 1; //the list engine took the top free frame
+    }
+    else {
+        struct PROCESS_MEMORY *owner = &mm->processes[page_owner(mm, victim)];
+
+        owner->resident -= 1;
+        owner->evictions += 1;
+        mm->evictions += 1;
+    }
+    process->resident += 1;
+    process->page_faults += 1;
+    mm->page_faults += 1;
+    return frame_number;
+}
+
+long long memory_manager_run(struct MEMORY_MANAGER *mm, int process_ids[], int reference_string[], int reference_cnt)
+{
+    /*Processes an interleaved trace where reference i is page reference_string[i] of process
+process_ids[i], giving each access the manager's next timestamp. Returns the number of page faults in
+this run, or -1 if an access fails or the timestamp reaches INT_MAX, INT_MAX - 1 references after the
+manager was created or reset.*/
+    long long page_faults = mm->page_faults;
+
+    for(int i = 0; i < reference_cnt; i++){
+        if(mm->timestamp == INT_MAX || memory_manager_access(mm, process_ids[i], reference_string[i], mm->timestamp) == -1){
+            return -1;
+        }
+        mm->timestamp += 1;
+    }
+    return mm->page_faults - page_faults;
+}
+
+long long memory_manager_run_trace(struct MEMORY_MANAGER *mm, struct TRACE_READER *trace)
+{
+    /*Same as memory_manager_run for a trace of alternating process IDs and page numbers, in any of the
+TRACE_ formats. Returns -1 if the trace cannot be read, ends after a process ID, names a process or
+page that does not exist or runs the timestamp up to INT_MAX.*/
+    long long page_faults = mm->page_faults;
+    long long process_id;
+    long long page_number;
+    int got;
+
+    while((got = trace_next(trace, &process_id)) == 1){
+        if(trace_next(trace, &page_number) != 1){
+            return -1;
+        }
+        if(process_id < 0 || process_id >= mm->process_cnt || page_number < 0 || page_number > 2147483647LL || mm->timestamp == INT_MAX){
+            return -1;
+        }
+        if(memory_manager_access(mm, (int)process_id, (int)page_number, mm->timestamp) == -1){
+            return -1;
+        }
+        mm->timestamp += 1;
+    }
+    if(got == -1){
+        return -1;
+    }
+    return mm->page_faults - page_faults;
+}
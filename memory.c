@@ -0,0 +1,585 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "oslabs.h"
+
+/*Contiguous memory allocation. The functions declared for the lab work on a memory map the caller
+keeps as an array of blocks in address order. A split inserts a block and a release may remove two,
+so every call shifts the tail of the array and costs O(n).
+
+A MEMORY_ALLOCATOR holds the same map for simulations with millions of blocks. Every block is a
+MEMORY_NODE linked to its neighbours in address order, so a release finds the blocks to coalesce with
+in O(1). Two treaps index the nodes. The size index holds the free blocks ordered by size and then
+address, which gives best fit and worst fit. The address index holds every block, and each node keeps
+the largest free block in its subtree, so first fit and next fit go straight to the lowest fitting
+address. Every operation is O(log n) expected. A node keeps its block, links and both indexes' children
+together, since a walk down a treap of millions of nodes is one cache miss per level.
+
+Both keep the lab's rules: a block is allocated from its low end and the rest stays free above it,
+ties go to the lowest address, and next fit looks from last_address up and then wraps around.*/
+
+static struct MEMORY_BLOCK null_block(void)
+{
+    struct MEMORY_BLOCK block = { 0, 0, 0, 0 };
+
+    return block;
+}
+
+static int fits(struct MEMORY_BLOCK *block, int request_size)
+{
+    return block->process_id == 0 && block->segment_size >= request_size;
+}
+
+static struct MEMORY_BLOCK map_allocate(int index,
+int request_size,
+struct MEMORY_BLOCK memory_map[],
+int *map_cnt,
+int process_id)
+{
+    //allocates the low end of free block index, moving the blocks above up to make room for the rest
+    struct MEMORY_BLOCK *block = &memory_map[index];
+
+    if(block->segment_size > request_size){
+        for(int i = *map_cnt; i > index + 1; i--){
+            memory_map[i] = memory_map[i - 1];
+        }
+        *map_cnt += 1;
+        memory_map[index + 1].start_address = block->start_address + request_size;
+        memory_map[index + 1].end_address = block->end_address;
+        memory_map[index + 1].segment_size = block->segment_size - request_size;
+        memory_map[index + 1].process_id = 0;
+        block->end_address = block->start_address + request_size - 1;
+        block->segment_size = request_size;
+    }
+    block->process_id = process_id;
+    return *block;
+}
+
+struct MEMORY_BLOCK best_fit_allocate(int request_size,
+struct MEMORY_BLOCK memory_map[MAPMAX],
+int *map_cnt,
+int process_id)
+{
+    /*Allocates request_size from the smallest free block that can hold it and returns the allocated
+block, or a block of all zeros if none can. A larger block is split, which needs room in memory_map
+for one more block than *map_cnt. MAPMAX is only the size the lab used.*/
+    int best = -1;
+
+    for(int i = 0; i < *map_cnt; i++){
+        if(fits(&memory_map[i], request_size) && (best == -1 || memory_map[i].segment_size < memory_map[best].segment_size)){
+            best = i;
+        }
+    }
+    if(best == -1 || request_size <= 0){
+        return null_block();
+    }
+    return map_allocate(best, request_size, memory_map, map_cnt, process_id);
+}
+
+struct MEMORY_BLOCK first_fit_allocate(int request_size,
+struct MEMORY_BLOCK memory_map[MAPMAX],
+int *map_cnt,
+int process_id)
+{
+    //same as best_fit_allocate but takes the lowest free block that can hold the request
+    for(int i = 0; i < *map_cnt && request_size > 0; i++){
+        if(fits(&memory_map[i], request_size)){
+            return map_allocate(i, request_size, memory_map, map_cnt, process_id);
+        }
+    }
+    return null_block();
+}
+
+struct MEMORY_BLOCK worst_fit_allocate(int request_size,
+struct MEMORY_BLOCK memory_map[MAPMAX],
+int *map_cnt,
+int process_id)
+{
+    //same as best_fit_allocate but takes the largest free block
+    int worst = -1;
+
+    for(int i = 0; i < *map_cnt; i++){
+        if(fits(&memory_map[i], request_size) && (worst == -1 || memory_map[i].segment_size > memory_map[worst].segment_size)){
+            worst = i;
+        }
+    }
+    if(worst == -1 || request_size <= 0){
+        return null_block();
+    }
+    return map_allocate(worst, request_size, memory_map, map_cnt, process_id);
+}
+
+struct MEMORY_BLOCK next_fit_allocate(int request_size,
+struct MEMORY_BLOCK memory_map[MAPMAX],
+int *map_cnt,
+int process_id,
+int last_address)
+{
+    /*Same as first_fit_allocate but starts at the first block at or above last_address, normally the
+start of the previous allocation, and wraps around to the bottom of memory.*/
+    int start = 0;
+
+    if(request_size <= 0){
+        return null_block();
+    }
+    while(start < *map_cnt && memory_map[start].start_address < last_address){
+        start += 1;
+    }
+    for(int i = 0; i < *map_cnt; i++){
+        int index = (start + i) % *map_cnt;
+
+        if(fits(&memory_map[index], request_size)){
+            return map_allocate(index, request_size, memory_map, map_cnt, process_id);
+        }
+    }
+    return null_block();
+}
+
+void release_memory(struct MEMORY_BLOCK freed_block,
+struct MEMORY_BLOCK memory_map[MAPMAX],
+int *map_cnt)
+{
+    /*Frees the block of the map that starts at freed_block.start_address and merges it with a free
+block just below or above it. Does nothing if no allocated block starts there.*/
+    int index = -1;
+    int merged = 0;
+
+    for(int i = 0; i < *map_cnt && index == -1; i++){
+        if(memory_map[i].start_address == freed_block.start_address && memory_map[i].process_id != 0){
+            index = i;
+        }
+    }
+    if(index == -1){
+        return;
+    }
+    memory_map[index].process_id = 0;
+    if(index + 1 < *map_cnt && memory_map[index + 1].process_id == 0){
+        memory_map[index].end_address = memory_map[index + 1].end_address;
+        memory_map[index].segment_size += memory_map[index + 1].segment_size;
+        merged += 1; //index + 1 goes
+    }
+    if(index > 0 && memory_map[index - 1].process_id == 0){
+        memory_map[index - 1].end_address = memory_map[index].end_address;
+        memory_map[index - 1].segment_size += memory_map[index].segment_size;
+        index -= 1;
+        merged += 1; //the old index goes
+    }
+    for(int i = index + 1; i + merged < *map_cnt; i++){
+        memory_map[i] = memory_map[i + merged];
+    }
+    *map_cnt -= merged;
+}
+
+#define BY_SIZE 0
+#define BY_ADDRESS 1
+
+static int node_less(struct MEMORY_ALLOCATOR *ma, int index, int a, int b)
+{
+    struct MEMORY_BLOCK *x = &ma->nodes[a].block;
+    struct MEMORY_BLOCK *y = &ma->nodes[b].block;
+
+    if(index == BY_SIZE && x->segment_size != y->segment_size){
+        return x->segment_size < y->segment_size;
+    }
+    return x->start_address < y->start_address;
+}
+
+static void node_pull(struct MEMORY_ALLOCATOR *ma, int index, int id)
+{
+    //recomputes the largest free block under the node, which only the address index keeps
+    struct MEMORY_NODE *node = &ma->nodes[id];
+    int best;
+
+    if(index == BY_SIZE){
+        return;
+    }
+    best = node->block.process_id == 0 ? node->block.segment_size : 0;
+    if(node->left[BY_ADDRESS] != -1){
+        best = MAX(best, ma->nodes[node->left[BY_ADDRESS]].max_free);
+    }
+    if(node->right[BY_ADDRESS] != -1){
+        best = MAX(best, ma->nodes[node->right[BY_ADDRESS]].max_free);
+    }
+    node->max_free = best;
+}
+
+static int index_merge(struct MEMORY_ALLOCATOR *ma, int index, int low, int high)
+{
+    //joins two treaps where every key of low is below every key of high
+    if(low == -1){
+        return high;
+    }
+    if(high == -1){
+        return low;
+    }
+    if(ma->nodes[low].priority > ma->nodes[high].priority){
+        ma->nodes[low].right[index] = index_merge(ma, index, ma->nodes[low].right[index], high);
+        node_pull(ma, index, low);
+        return low;
+    }
+    ma->nodes[high].left[index] = index_merge(ma, index, low, ma->nodes[high].left[index]);
+    node_pull(ma, index, high);
+    return high;
+}
+
+static void index_split(struct MEMORY_ALLOCATOR *ma, int index, int tree, int id, int *low, int *high)
+{
+    //splits tree into the nodes ordered before id and the rest
+    if(tree == -1){
+        *low = -1;
+        *high = -1;
+        return;
+    }
+    if(node_less(ma, index, tree, id)){
+        index_split(ma, index, ma->nodes[tree].right[index], id, &ma->nodes[tree].right[index], high);
+        *low = tree;
+    }
+    else {
+        index_split(ma, index, ma->nodes[tree].left[index], id, low, &ma->nodes[tree].left[index]);
+        *high = tree;
+    }
+    node_pull(ma, index, tree);
+}
+
+static int index_insert(struct MEMORY_ALLOCATOR *ma, int index, int tree, int id)
+{
+    struct MEMORY_NODE *node = &ma->nodes[id];
+
+    if(tree == -1 || node->priority > ma->nodes[tree].priority){
+        index_split(ma, index, tree, id, &node->left[index], &node->right[index]);
+        node_pull(ma, index, id);
+        return id;
+    }
+    if(node_less(ma, index, id, tree)){
+        ma->nodes[tree].left[index] = index_insert(ma, index, ma->nodes[tree].left[index], id);
+    }
+    else {
+        ma->nodes[tree].right[index] = index_insert(ma, index, ma->nodes[tree].right[index], id);
+    }
+    node_pull(ma, index, tree);
+    return tree;
+}
+
+static int index_remove(struct MEMORY_ALLOCATOR *ma, int index, int tree, int id)
+{
+    //id must be in tree with the key it was inserted with
+    struct MEMORY_NODE *node = &ma->nodes[id];
+
+    if(tree == id){
+        tree = index_merge(ma, index, node->left[index], node->right[index]);
+        node->left[index] = -1;
+        node->right[index] = -1;
+        return tree;
+    }
+    if(node_less(ma, index, id, tree)){
+        ma->nodes[tree].left[index] = index_remove(ma, index, ma->nodes[tree].left[index], id);
+    }
+    else {
+        ma->nodes[tree].right[index] = index_remove(ma, index, ma->nodes[tree].right[index], id);
+    }
+    node_pull(ma, index, tree);
+    return tree;
+}
+
+static void address_refresh(struct MEMORY_ALLOCATOR *ma, int tree, int id)
+{
+    //recomputes max_free from the node up to the root after its free size changed but not its address
+    if(tree != id){
+        address_refresh(ma, node_less(ma, BY_ADDRESS, id, tree) ? ma->nodes[tree].left[BY_ADDRESS] : ma->nodes[tree].right[BY_ADDRESS], id);
+    }
+    node_pull(ma, BY_ADDRESS, tree);
+}
+
+static void free_insert(struct MEMORY_ALLOCATOR *ma, int id)
+{
+    ma->roots[BY_SIZE] = index_insert(ma, BY_SIZE, ma->roots[BY_SIZE], id);
+    ma->free_cnt += 1;
+    ma->free_size += ma->nodes[id].block.segment_size;
+}
+
+static void free_remove(struct MEMORY_ALLOCATOR *ma, int id)
+{
+    //takes a free block out of the size index before its size changes or it is allocated
+    ma->roots[BY_SIZE] = index_remove(ma, BY_SIZE, ma->roots[BY_SIZE], id);
+    ma->free_cnt -= 1;
+    ma->free_size -= ma->nodes[id].block.segment_size;
+}
+
+static int node_new(struct MEMORY_ALLOCATOR *ma)
+{
+    //an unused node with a fresh treap priority, -1 if all block_cap nodes are in use
+    struct MEMORY_NODE *node;
+    int id;
+
+    if(ma->spare_cnt == 0){
+        return -1;
+    }
+    id = ma->spare_ids[--ma->spare_cnt];
+    node = &ma->nodes[id];
+    node->priority = (unsigned int)(xorshift64(&ma->rng_state) >> 32);
+    node->left[BY_SIZE] = -1;
+    node->right[BY_SIZE] = -1;
+    node->left[BY_ADDRESS] = -1;
+    node->right[BY_ADDRESS] = -1;
+    ma->block_cnt += 1;
+    return id;
+}
+
+static void node_unlink(struct MEMORY_ALLOCATOR *ma, int id)
+{
+    //drops a node that has been merged into its neighbour and is in neither index
+    struct MEMORY_NODE *node = &ma->nodes[id];
+
+    if(node->prev != -1){
+        ma->nodes[node->prev].next = node->next;
+    }
+    if(node->next != -1){
+        ma->nodes[node->next].prev = node->prev;
+    }
+    ma->spare_ids[ma->spare_cnt++] = id;
+    ma->block_cnt -= 1;
+}
+
+static int find_best(struct MEMORY_ALLOCATOR *ma, int request_size)
+{
+    //smallest free block of at least request_size, lowest address among equals
+    int best = -1;
+
+    for(int id = ma->roots[BY_SIZE]; id != -1; ){
+        if(ma->nodes[id].block.segment_size >= request_size){
+            best = id;
+            id = ma->nodes[id].left[BY_SIZE];
+        }
+        else {
+            id = ma->nodes[id].right[BY_SIZE];
+        }
+    }
+    return best;
+}
+
+static int find_worst(struct MEMORY_ALLOCATOR *ma, int request_size)
+{
+    //largest free block, lowest address among equals
+    int id = ma->roots[BY_SIZE];
+
+    if(id == -1){
+        return -1;
+    }
+    while(ma->nodes[id].right[BY_SIZE] != -1){
+        id = ma->nodes[id].right[BY_SIZE];
+    }
+    if(ma->nodes[id].block.segment_size < request_size){
+        return -1;
+    }
+    return find_best(ma, ma->nodes[id].block.segment_size);
+}
+
+static int find_first(struct MEMORY_ALLOCATOR *ma, int tree, int request_size, int low_address)
+{
+    /*Lowest free block at or above low_address that holds request_size. Subtrees whose largest free
+block is too small are skipped whole, so only the path to low_address and the path down to the block
+found are walked.*/
+    struct MEMORY_NODE *node;
+    int found;
+
+    if(tree == -1 || ma->nodes[tree].max_free < request_size){
+        return -1;
+    }
+    node = &ma->nodes[tree];
+    if(node->block.start_address < low_address){
+        return find_first(ma, node->right[BY_ADDRESS], request_size, low_address);
+    }
+    found = find_first(ma, node->left[BY_ADDRESS], request_size, low_address);
+    if(found == -1 && fits(&node->block, request_size)){
+        found = tree;
+    }
+    if(found == -1){
+        found = find_first(ma, node->right[BY_ADDRESS], request_size, low_address);
+    }
+    return found;
+}
+
+struct MEMORY_ALLOCATOR *memory_allocator_create(int memory_size, int block_cap)
+{
+    /*Creates an allocator over addresses 0 to memory_size - 1, all in one free block, with room for
+block_cap blocks. Returns NULL if either is not positive or the arena cannot be allocated.*/
+    struct ARENA arena;
+    struct MEMORY_ALLOCATOR *ma;
+    struct MEMORY_NODE *node;
+    int id;
+
+    if(memory_size <= 0 || block_cap <= 0){
+        return NULL;
+    }
+    arena.base = malloc(arena_size(sizeof(struct MEMORY_ALLOCATOR))
+        + arena_size((size_t)block_cap * sizeof(struct MEMORY_NODE)) + arena_size((size_t)block_cap * sizeof(int)));
+    arena.used = 0;
+    if(arena.base == NULL){
+        return NULL;
+    }
+    ma = arena_take(&arena, sizeof(struct MEMORY_ALLOCATOR));
+    ma->arena = arena.base;
+    ma->block_cap = block_cap;
+    ma->nodes = arena_take(&arena, (size_t)block_cap * sizeof(struct MEMORY_NODE));
+    ma->spare_ids = arena_take(&arena, (size_t)block_cap * sizeof(int));
+    for(int i = 0; i < block_cap; i++){
+        ma->spare_ids[i] = block_cap - 1 - i; //node 0 is handed out first
+    }
+    ma->spare_cnt = block_cap;
+    ma->roots[BY_SIZE] = -1;
+    ma->roots[BY_ADDRESS] = -1;
+    ma->block_cnt = 0;
+    ma->free_cnt = 0;
+    ma->free_size = 0;
+    ma->last_address = 0;
+    ma->rng_state = XORSHIFT64_SEED;
+    id = node_new(ma);
+    node = &ma->nodes[id];
+    node->block.start_address = 0;
+    node->block.end_address = memory_size - 1;
+    node->block.segment_size = memory_size;
+    node->block.process_id = 0;
+    node->prev = -1;
+    node->next = -1;
+    ma->roots[BY_ADDRESS] = index_insert(ma, BY_ADDRESS, -1, id);
+    free_insert(ma, id);
+    return ma;
+}
+
+void memory_allocator_destroy(struct MEMORY_ALLOCATOR *ma)
+{
+    if(ma != NULL){
+        free(ma->arena); //the allocator itself lives in the arena
+    }
+}
+
+struct MEMORY_BLOCK memory_allocator_allocate(struct MEMORY_ALLOCATOR *ma, int fit, int request_size, int process_id)
+{
+    /*Allocates request_size for process_id, choosing the free block by fit, one of the FIT_ values, the
+way the matching *_fit_allocate function would on the same map. FIT_NEXT starts at the previous
+allocation. Returns the allocated block, or a block of all zeros if no free block can hold the request,
+process_id is 0 or a split needs more than block_cap blocks.*/
+    struct MEMORY_NODE *node;
+    int id;
+    int rest = -1;
+
+    if(request_size <= 0 || process_id == 0){
+        return null_block();
+    }
+    switch(fit){
+    case FIT_FIRST:
+        id = find_first(ma, ma->roots[BY_ADDRESS], request_size, 0);
+        break;
+    case FIT_NEXT:
+        id = find_first(ma, ma->roots[BY_ADDRESS], request_size, ma->last_address);
+        if(id == -1){
+            id = find_first(ma, ma->roots[BY_ADDRESS], request_size, 0); //wraps around
+        }
+        break;
+    case FIT_BEST:
+        id = find_best(ma, request_size);
+        break;
+    case FIT_WORST:
+        id = find_worst(ma, request_size);
+        break;
+    default:
+        return null_block();
+    }
+    if(id == -1){
+        return null_block();
+    }
+    node = &ma->nodes[id];
+    if(node->block.segment_size > request_size){
+        struct MEMORY_NODE *above;
+
+        rest = node_new(ma);
+        if(rest == -1){
+            return null_block();
+        }
+        above = &ma->nodes[rest];
+        above->block.start_address = node->block.start_address + request_size;
+        above->block.end_address = node->block.end_address;
+        above->block.segment_size = node->block.segment_size - request_size;
+        above->block.process_id = 0;
+        above->prev = id;
+        above->next = node->next;
+        if(node->next != -1){
+            ma->nodes[node->next].prev = rest;
+        }
+        node->next = rest;
+    }
+    free_remove(ma, id);
+    node->block.process_id = process_id;
+    if(rest != -1){
+        node->block.end_address = node->block.start_address + request_size - 1;
+        node->block.segment_size = request_size;
+        free_insert(ma, rest);
+        ma->roots[BY_ADDRESS] = index_insert(ma, BY_ADDRESS, ma->roots[BY_ADDRESS], rest);
+    }
+    address_refresh(ma, ma->roots[BY_ADDRESS], id); //its address is the same, only its free size went
+    ma->last_address = node->block.start_address;
+    return node->block;
+}
+
+int memory_allocator_release(struct MEMORY_ALLOCATOR *ma, struct MEMORY_BLOCK freed_block)
+{
+    /*Same as release_memory: frees the allocated block starting at freed_block.start_address and
+merges it with free neighbours. Returns -1 if no allocated block starts there.*/
+    struct MEMORY_NODE *node;
+    int id = ma->roots[BY_ADDRESS];
+    int neighbour;
+
+    while(id != -1 && ma->nodes[id].block.start_address != freed_block.start_address){
+        node = &ma->nodes[id];
+        id = freed_block.start_address < node->block.start_address ? node->left[BY_ADDRESS] : node->right[BY_ADDRESS];
+    }
+    if(id == -1 || ma->nodes[id].block.process_id == 0){
+        return -1;
+    }
+    node = &ma->nodes[id];
+    node->block.process_id = 0;
+    neighbour = node->next;
+    if(neighbour != -1 && ma->nodes[neighbour].block.process_id == 0){
+        free_remove(ma, neighbour);
+        ma->roots[BY_ADDRESS] = index_remove(ma, BY_ADDRESS, ma->roots[BY_ADDRESS], neighbour);
+        node->block.end_address = ma->nodes[neighbour].block.end_address;
+        node->block.segment_size += ma->nodes[neighbour].block.segment_size;
+        node_unlink(ma, neighbour);
+    }
+    neighbour = node->prev;
+    if(neighbour != -1 && ma->nodes[neighbour].block.process_id == 0){
+        free_remove(ma, neighbour);
+        ma->roots[BY_ADDRESS] = index_remove(ma, BY_ADDRESS, ma->roots[BY_ADDRESS], id);
+        ma->nodes[neighbour].block.end_address = node->block.end_address;
+        ma->nodes[neighbour].block.segment_size += node->block.segment_size;
+        node_unlink(ma, id);
+        id = neighbour;
+    }
+    free_insert(ma, id);
+    address_refresh(ma, ma->roots[BY_ADDRESS], id);
+    return 0;
+}
+
+int memory_allocator_largest_free(struct MEMORY_ALLOCATOR *ma)
+{
+    //size of the largest free block, 0 if memory is full
+    return ma->roots[BY_ADDRESS] == -1 ? 0 : ma->nodes[ma->roots[BY_ADDRESS]].max_free;
+}
+
+int memory_allocator_export(struct MEMORY_ALLOCATOR *ma, struct MEMORY_BLOCK memory_map[], int map_cap)
+{
+    /*Copies up to map_cap blocks into memory_map in address order, in the layout the *_fit_allocate
+functions use, and returns the number of blocks in the map.*/
+    int id = ma->roots[BY_ADDRESS];
+    int cnt = 0;
+
+    while(id != -1 && ma->nodes[id].left[BY_ADDRESS] != -1){
+        id = ma->nodes[id].left[BY_ADDRESS];
+    }
+    for(; id != -1; id = ma->nodes[id].next){
+        if(cnt < map_cap){
+            memory_map[cnt] = ma->nodes[id].block;
+        }
+        cnt += 1;
+    }
+    return cnt;
+}
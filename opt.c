@@ -0,0 +1,180 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "oslabs.h"
+
+/*Belady's optimal replacement (OPT, also called MIN): on a fault with no free frame, replace the page
+whose next reference is furthest in the future, or one that is never referenced again. No policy that
+only sees the past can fault less, so count_page_faults_opt is the lower bound to judge the others
+against.
+
+The future is read once. A backward pass over the reference string gives every reference the position
+of the next reference to the same page, and the pages in memory sit in a max-heap keyed on their next
+use. A hit moves its page down the future and up the heap, a fault with no free frame pops the root,
+so a run costs O(n log k) for n references and k frames instead of a scan of the future per fault.*/
+
+struct OPT_SLOT {
+        int next_use; //kept next to the page number so sifting reads one array
+        int page_number;
+    };
+
+struct OPT_HEAP {
+        struct OPT_SLOT *slots; //pages in memory, furthest next use at slots[0]
+        int *position; //indexed by page number, index into slots, -1 when not in memory
+        int size;
+    };
+
+static void heap_sift_up(struct OPT_HEAP *heap, int index, struct OPT_SLOT slot)
+{
+    while(index > 0){
+        int parent = (index - 1) / 2;
+        if(heap->slots[parent].next_use >= slot.next_use){
+            break;
+        }
+        heap->slots[index] = heap->slots[parent];
+        heap->position[heap->slots[index].page_number] = index;
+        index = parent;
+    }
+    heap->slots[index] = slot;
+    heap->position[slot.page_number] = index;
+}
+
+static void heap_sift_down(struct OPT_HEAP *heap, int index, struct OPT_SLOT slot)
+{
+    while(1){
+        int child = 2 * index + 1;
+        if(child >= heap->size){
+            break;
+        }
+        if(child + 1 < heap->size && heap->slots[child + 1].next_use > heap->slots[child].next_use){
+            child += 1;
+        }
+        if(heap->slots[child].next_use <= slot.next_use){
+            break;
+        }
+        heap->slots[index] = heap->slots[child];
+        heap->position[heap->slots[index].page_number] = index;
+        index = child;
+    }
+    heap->slots[index] = slot;
+    heap->position[slot.page_number] = index;
+}
+
+static void heap_push(struct OPT_HEAP *heap, int page_number, int next_use)
+{
+    struct OPT_SLOT slot = { next_use, page_number };
+
+    heap->size += 1;
+    heap_sift_up(heap, heap->size - 1, slot);
+}
+
+static int heap_pop(struct OPT_HEAP *heap)
+{
+    //removes and returns the page whose next reference is furthest away
+    int root = heap->slots[0].page_number;
+
+    heap->size -= 1;
+    heap->position[root] = -1;
+    if(heap->size > 0){
+        heap_sift_down(heap, 0, heap->slots[heap->size]);
+    }
+    return root;
+}
+
+int count_page_faults_opt(struct PTE page_table[],
+int table_cnt,
+int reference_string[],
+int reference_cnt,
+int frame_pool[],
+int frame_cnt)
+{
+    /*Returns the number of page faults for the reference string under optimal replacement, with the
+same inputs, timestamps and page-table updates as count_page_faults_fifo. Pages already in memory
+stay until OPT replaces them. Among pages that are never referenced again, which one goes first does
+not change the count. Returns -1 if the work arrays cannot be allocated, the reference string names a
+page outside the page table or a fault finds neither a free frame nor a page in memory to replace.*/
+    struct ARENA arena;
+    struct OPT_HEAP heap;
+    int *following; //following[i] is the position of the next reference to reference_string[i]
+    int *first_use; //indexed by page number, position of the page's first reference
+    int page_fault_counter = 0;
+
+    if(table_cnt <= 0 || reference_cnt < 0){
+        return -1;
+    }
+    arena.base = malloc(arena_size((size_t)reference_cnt * sizeof(int)) + arena_size((size_t)table_cnt * sizeof(struct OPT_SLOT))
+        + 2 * arena_size((size_t)table_cnt * sizeof(int)));
+    arena.used = 0;
+    if(arena.base == NULL){
+        return -1;
+    }
+    following = arena_take(&arena, (size_t)reference_cnt * sizeof(int));
+    heap.slots = arena_take(&arena, (size_t)table_cnt * sizeof(struct OPT_SLOT));
+    heap.position = arena_take(&arena, (size_t)table_cnt * sizeof(int));
+    first_use = arena_take(&arena, (size_t)table_cnt * sizeof(int));
+    heap.size = 0;
+    for(int i = 0; i < table_cnt; i++){
+        heap.position[i] = -1;
+        first_use[i] = reference_cnt; //never referenced
+    }
+    for(int i = reference_cnt - 1; i >= 0; i--){
+        int page_number = reference_string[i];
+        if(page_number < 0 || page_number >= table_cnt){
+            free(arena.base);
+            return -1;
+        }
+        following[i] = first_use[page_number];
+        first_use[page_number] = i;
+    }
+    for(int i = 0; i < table_cnt; i++){
+        if(page_table[i].is_valid != 0){
+            heap_push(&heap, i, first_use[i]);
+        }
+    }
+
+    for(int i = 0; i < reference_cnt; i++){
+        int page_number = reference_string[i];
+        struct PTE *entry = &page_table[page_number];
+        int current_timestamp = i + 1;
+
+        if(entry->is_valid != 0){
+            struct OPT_SLOT *slot = &heap.slots[heap.position[page_number]];
+
+            entry->reference_count += 1; //update reference count
+            entry->reference_bit = 1;
+            entry->last_access_timestamp = current_timestamp; //update time
+            slot->next_use = following[i]; //only ever moves further away, so the page can only rise
+            heap_sift_up(&heap, heap.position[page_number], *slot);
+            continue;
+        }
+        page_fault_counter++;
+        if(frame_cnt > 0){
+            frame_cnt -= 1; //lowers frame count
+            entry->frame_number = frame_pool[frame_cnt];
+        }
+        else {
+            int victim;
+
+            if(heap.size == 0){
+                free(arena.base);
+                return -1;
+            }
+            victim = heap_pop(&heap);
+            entry->frame_number = page_table[victim].frame_number; //replaces the page in memory
+
+            page_table[victim].frame_number = -1;
+            page_table[victim].is_valid = 0;
+            page_table[victim].arrival_timestamp = -1;
+            page_table[victim].last_access_timestamp = -1;
+            page_table[victim].reference_count = -1;
+            page_table[victim].reference_bit = 0;
+        }
+        entry->is_valid = 1;
+        entry->arrival_timestamp = current_timestamp;
+        entry->last_access_timestamp = current_timestamp;
+        entry->reference_count = 1;
+        entry->reference_bit = 1;
+        heap_push(&heap, page_number, following[i]);
+    }
+    free(arena.base);
+    return page_fault_counter;
+}
@@ -1,3 +1,5 @@
+#include <stddef.h>
+#include <stdio.h>
 #define QUEUEMAX 10
 #define MAPMAX 10
 #define TABLEMAX 10
@@ -5,6 +7,59 @@
 #define REFERENCEMAX 20
 #define MAX( a, b ) ( ( a > b) ? a : b ) 
 #define MIN( a, b ) ( ( a > b) ? b : a ) 
+#define POLICY_FIFO 0
+#define POLICY_LRU 1
+#define POLICY_LFU 2
+#define POLICY_CLOCK 3
+#define POLICY_CLOCK_PRO 4
+#define POLICY_ARC 5
+#define POLICY_2Q 6
+#define TRACE_U32 0 //packed little-endian 32-bit page numbers
+#define TRACE_U64 1 //packed little-endian 64-bit page numbers
+#define TRACE_TEXT 2 //decimal page numbers separated by anything that is not a digit, a '-' before one is an error
+#define TRACE_VARINT 3 //unsigned LEB128 page numbers
+#define TRACE_CHUNK 65536
+#define ARENA_ALIGN 16
+#define XORSHIFT64_SEED 88172645463325252ULL //starting state of every xorshift64 generator, so runs repeat
+#define PTE_KERNEL_SCALAR 0
+#define PTE_KERNEL_SSE41 1
+#define PTE_KERNEL_AVX2 2
+#define SCOPE_GLOBAL 0 //a fault may replace any process's page
+#define SCOPE_LOCAL 1 //a fault at its quota replaces one of the process's own pages
+#define TLB_REPLACE_LRU 0
+#define TLB_REPLACE_FIFO 1
+#define TLB_REPLACE_RANDOM 2
+#define FIT_FIRST 0
+#define FIT_NEXT 1
+#define FIT_BEST 2
+#define FIT_WORST 3
+#define DISK_FCFS 0
+#define DISK_SSTF 1
+#define DISK_LOOK 2
+#define CPU_PP 0
+#define CPU_SRTP 1
+#define CPU_RR 2
+#define SHARDS_MODULUS 16777216LL //hash values the sampling rate is counted in
+#define PREFETCH_NONE 0
+#define PREFETCH_NEXT_N 1 //the depth pages after the trigger
+#define PREFETCH_STRIDE 2 //depth pages along a stride seen twice in a row
+#define PREFETCH_ADAPTIVE 3 //a window that grows to depth while the stream stays sequential
+#define INSTRUMENT_BUCKETS 32 //bucket 0 counts 0, bucket b counts 2^(b-1) to 2^b - 1, the last one everything above
+#define INSTRUMENT_EVENT_HIT 0
+#define INSTRUMENT_EVENT_FAULT 1
+#define INSTRUMENT_EVENT_EVICT 2
+#define INSTRUMENT_EVENT_PREFETCH 3 //a page loaded ahead of its reference, neither a hit nor a fault
+#ifdef OSLABS_INSTRUMENT
+#define INSTRUMENT_ACCESS( ctx, page_number, frame_number, hit, prefetch, timestamp ) instrument_access( ctx, page_number, frame_number, hit, prefetch, timestamp )
+#define INSTRUMENT_EVICT( ctx, page_number, timestamp ) instrument_evict( ctx, page_number, timestamp )
+#define INSTRUMENT_RUN_BEGIN() instrument_run_begin()
+#define INSTRUMENT_RUN_END( reference_cnt ) instrument_run_end( reference_cnt )
+#else
+#define INSTRUMENT_ACCESS( ctx, page_number, frame_number, hit, prefetch, timestamp ) ((void)0)
+#define INSTRUMENT_EVICT( ctx, page_number, timestamp ) ((void)0)
+#define INSTRUMENT_RUN_BEGIN() ((void)0)
+#define INSTRUMENT_RUN_END( reference_cnt ) ((void)0)
+#endif
 
 
 struct RCB {
@@ -39,6 +94,377 @@ struct PTE {
         int arrival_timestamp;
         int last_access_timestamp;
         int reference_count;
+        int reference_bit; //set on every access, cleared by the CLOCK hands
+    };
+
+struct PTE_TABLE {
+        int *is_valid; //each field of struct PTE in its own array, indexed by page number
+        int *frame_number;
+        int *arrival_timestamp;
+        int *last_access_timestamp;
+        int *reference_count;
+        int *reference_bit;
+        int table_cnt;
+        int kernel; //PTE_KERNEL_ the victim searches use, may be lowered to compare kernels
+        void *arena;
+    };
+
+struct ARENA {
+        char *base;
+        size_t used;
+    };
+
+struct LRU_LIST {
+        int *prev; //indexed by page number, links resident pages in recency order
+        int *next;
+        int head; //least recently used resident page, -1 when empty
+        int tail; //most recently used resident page, -1 when empty
+        int size;
+        const long long *rank; //indexed by page number, orders CLOCK's ties instead of the page number when not NULL
+    };
+
+struct LFU_TABLE {
+        int *heap; //resident pages, a min-heap on (reference_count, arrival_timestamp, page number)
+        int *position; //indexed by page number, its index in heap, -1 when not in memory
+        int size;
+    };
+
+struct CLOCK_PRO {
+        int *next; //indexed by page number, ring of hot, cold and test pages
+        int *prev;
+        int *type; //hot, cold, test or not on the ring
+        int *hot_next; //indexed by page number, links the hot pages in ring order
+        int *hot_prev;
+        int hot_cursor; //hot page the hot hand reaches next, -1 when there is none
+        int *released; //frames freed by the cold hand and not yet reused
+        int released_cnt;
+        int hand_hot;
+        int hand_cold;
+        int hand_test;
+        int count_hot;
+        int count_cold;
+        int count_test;
+        int mem_max; //frames in the pool
+        int mem_cold; //frames cold pages may use, adapts between 1 and mem_max - 1
+        int evicted_page; //page the current access moved out of memory, -1 if none
+        long long evictions;
+        long long test_hits; //faults on pages still in their test period
+    };
+
+struct ARC {
+        struct LRU_LIST t1; //resident pages referenced once since they came in, least recent at the head
+        struct LRU_LIST t2; //resident pages referenced at least twice
+        struct LRU_LIST b1; //ghosts of pages evicted from t1
+        struct LRU_LIST b2; //ghosts of pages evicted from t2
+        int *list; //indexed by page number, which of the four lists holds the page
+        int target; //size t1 is steered toward, adapts between 0 and frames
+        int frames; //pages that fit in memory
+        int evicted_page; //page the current access moved out of memory, -1 if none
+        long long evictions;
+        long long b1_hits; //faults on ghosts of pages referenced once
+        long long b2_hits; //faults on ghosts of pages referenced more than once
+    };
+
+struct TWO_QUEUE {
+        struct LRU_LIST a1in; //resident pages on their first stay, in arrival order
+        struct LRU_LIST a1out; //ghosts of pages pushed out of a1in
+        struct LRU_LIST am; //resident pages that came back from a1out, least recent at the head
+        int *list; //indexed by page number, which of the three lists holds the page
+        int frames; //pages that fit in memory
+        int in_max; //pages a1in holds before it gives them up
+        int out_max; //ghosts a1out remembers
+        int evicted_page; //page the current access moved out of memory, -1 if none
+        long long evictions;
+        long long a1out_hits; //faults on ghosts, which go straight to am
+    };
+
+struct PAGE_CONTEXT {
+        int policy; //one of the POLICY_ values
+        struct PTE *page_table;
+        int table_cnt;
+        int *frame_pool;
+        int frame_cnt; //free frames left in frame_pool
+        int pool_cnt; //frames frame_pool can hold
+        int timestamp; //timestamp page_context_run gives the next access
+        long long page_hits;
+        long long page_faults;
+        long long evictions;
+        long long ghost_hits; //faults on pages an adaptive policy still remembered after evicting them
+        int evicted_page; //page replaced by the last access, -1 if none
+        int has_engine; //0 for a view, which finds victims by scanning the page table
+        struct LRU_LIST list; //FIFO and LRU order
+        struct LFU_TABLE lfu;
+        struct CLOCK_PRO clockpro;
+        struct ARC arc;
+        struct TWO_QUEUE two_queue;
+        int *last_reference; //timestamp of each page's latest reference, NULL unless built with OSLABS_INSTRUMENT
+        int *loaded_at; //timestamp each page was last loaded, NULL unless built with OSLABS_INSTRUMENT
+        void *arena; //single allocation holding the context and everything it owns
+    };
+
+struct TRACE_READER {
+        int format; //one of the TRACE_ formats
+        int fd;
+        int owns_fd; //1 when trace_open opened the file and trace_close must close it
+        const unsigned char *map; //whole file when it could be mapped, NULL when reading in chunks
+        long long map_size;
+        long long offset; //next byte of map to read
+        int chunk_len;
+        int chunk_pos;
+        long long references; //page numbers returned so far
+        unsigned char chunk[TRACE_CHUNK];
+    };
+
+struct STACK_DISTANCE {
+        int table_cnt;
+        int *last_position; //position of each page's latest reference, 0 if not referenced yet
+        int *page_at; //page referenced at each position
+        int *tree; //Fenwick tree over positions, 1 where some page's latest reference sits
+        int capacity; //positions available before the tree is compacted
+        int position; //last position handed out
+        int distinct; //pages referenced so far
+        long long *histogram; //histogram[d] counts references at stack distance d, 1 <= d <= table_cnt
+        long long cold_misses; //first references, which miss for every frame count
+        long long references;
+        void *arena;
+    };
+
+struct SWEEP_TRACE {
+        int *reference_string;
+        int reference_cnt;
+        int table_cnt;
+    };
+
+struct SWEEP_JOB {
+        int policy;
+        int frame_cnt;
+        int trace; //index into the traces passed to sweep_run
+    };
+
+struct SWEEP_RESULT {
+        int policy;
+        int frame_cnt;
+        int trace;
+        int status; //0 when the job ran, -1 when it could not
+        long long page_faults;
+        long long page_hits;
+        long long evictions;
+        long long ghost_hits;
+        long long elapsed_ns;
+    };
+
+struct PROCESS_MEMORY {
+        int base; //global index of the process's page 0
+        int table_cnt;
+        int quota; //most frames the process may hold under SCOPE_LOCAL
+        int resident; //pages of the process in memory
+        struct LRU_LIST list; //the process's own replacement order under SCOPE_LOCAL
+        long long page_faults;
+        long long page_hits;
+        long long evictions; //pages of this process replaced, by any process
+    };
+
+struct MEMORY_MANAGER {
+        int policy; //POLICY_FIFO, POLICY_LRU or POLICY_CLOCK
+        int scope; //SCOPE_GLOBAL or SCOPE_LOCAL
+        int process_cnt;
+        struct PROCESS_MEMORY *processes;
+        struct PTE *page_table; //every process's page table, one after the other
+        int page_cnt;
+        int *frame_pool;
+        int frame_cnt; //free frames left in frame_pool
+        int pool_cnt;
+        int timestamp; //timestamp memory_manager_run gives the next access
+        struct LRU_LIST list; //replacement order of every page in memory under SCOPE_GLOBAL
+        long long page_faults;
+        long long page_hits;
+        long long evictions;
+        void *arena;
+    };
+
+struct TLB {
+        int entry_cnt;
+        int ways; //entries per set, entry_cnt for a fully associative TLB
+        int set_cnt;
+        int policy; //one of the TLB_REPLACE_ values
+        int *page_number; //page each entry translates, -1 when empty, set s is entries s * ways on
+        int *frame_number;
+        long long *stamp; //last use under TLB_REPLACE_LRU, fill otherwise
+        long long tick;
+        unsigned long long rng_state; //xorshift64 state for TLB_REPLACE_RANDOM
+        long long hits;
+        long long misses;
+        long long shootdowns; //entries dropped because their page left memory
+        void *arena;
+    };
+
+struct SPARSE_TABLE {
+        int hash_bits; //the hash has 1 << hash_bits buckets
+        long long *keys; //page number in each bucket, -1 when empty
+        int *slots; //slot of ctx->page_table holding the page in each bucket
+        int slot_cnt; //pool_cnt + 1
+        long long *page_at; //page number in each slot, -1 when free
+        int *free_slots;
+        int free_cnt;
+        struct PAGE_CONTEXT *ctx; //runs the policy over the slots and holds the counters
+        void *arena;
+    };
+
+struct MEMORY_NODE {
+        struct MEMORY_BLOCK block;
+        int prev; //block just below in memory, -1 at the bottom
+        int next; //block just above in memory, -1 at the top
+        int left[2]; //children in the size index [0] and the address index [1], -1 for none
+        int right[2];
+        int max_free; //largest free segment_size in the node's subtree of the address index
+        unsigned int priority; //treap priority, the same in both indexes
+    };
+
+struct MEMORY_ALLOCATOR {
+        struct MEMORY_NODE *nodes; //indexed by block id
+        int roots[2]; //treap roots: free blocks by segment_size then start_address, every block by start_address
+        int *spare_ids; //node ids not in use
+        int spare_cnt;
+        int block_cap;
+        int block_cnt; //blocks in the map, free or not
+        int free_cnt; //free blocks
+        long long free_size; //total size of the free blocks
+        int last_address; //where FIT_NEXT starts looking, the start of the previous allocation
+        unsigned long long rng_state; //xorshift64 state for treap priorities
+        void *arena;
+    };
+
+struct DISK_NODE {
+        struct RCB request;
+        long long order; //position in the order requests were queued, the last tie-break
+        int left; //treap children under SSTF and LOOK, -1 for none
+        int right;
+        unsigned int priority;
+    };
+
+struct DISK_QUEUE {
+        int policy; //one of the DISK_ values
+        struct DISK_NODE *nodes; //indexed by node id
+        int *heap; //node ids in arrival order under DISK_FCFS
+        int root; //treap of node ids by cylinder under DISK_SSTF and DISK_LOOK
+        int *spare_ids; //node ids not in use
+        int spare_cnt;
+        int capacity;
+        int queue_cnt;
+        long long order; //order the next request gets
+        unsigned long long rng_state; //xorshift64 state for treap priorities
+        void *arena; //holds nodes, heap and spare_ids, replaced when the queue grows
+    };
+
+struct DISK_STATS {
+        long long requests;
+        long long seek_distance; //cylinders the head travelled
+        long long busy_time; //time spent seeking and transferring
+        long long total_response; //sum over requests of completion minus arrival
+        long long max_response;
+        long long makespan; //first arrival to last completion
+        long long elapsed_ns; //wall time spent in the scheduler and the replay loop
+    };
+
+struct READY_SLOT {
+        struct PCB process;
+        long long order; //position in the order processes were queued, the tie-break
+    };
+
+struct READY_QUEUE {
+        int policy; //one of the CPU_ values
+        struct READY_SLOT *slots; //a binary heap under CPU_PP and CPU_SRTP, a ring buffer from head under CPU_RR
+        int head;
+        int capacity;
+        int queue_cnt;
+        long long order; //order the next process gets
+    };
+
+struct CPU_STATS {
+        long long processes;
+        long long dispatches; //times a process was given the CPU
+        long long total_turnaround; //sum over processes of completion minus arrival
+        long long total_waiting; //sum over processes of turnaround minus total_bursttime
+        long long max_waiting;
+        long long makespan; //first arrival to last completion
+        long long elapsed_ns; //wall time spent in the scheduler and the replay loop
+    };
+
+struct RESIDENT_STATS {
+        long long references;
+        long long page_faults;
+        long long replacements; //faults that took a resident page's frame instead of a free one
+        long long releases; //pages that left memory to shrink the resident set
+        long long resident_sum; //resident set size after each reference, summed, the space-time product
+        int max_resident;
+        int phase_cnt; //entries filled in phase_faults
+    };
+
+struct SHARDS_SAMPLE {
+        double rate; //fraction of the page space sampled, threshold / SHARDS_MODULUS
+        long long threshold; //a page is sampled when its hash modulo SHARDS_MODULUS is below this
+        long long references; //every reference offered, sampled or not
+        int *reference_string; //sampled references as dense page indices
+        int reference_cnt;
+        int reference_cap;
+        int table_cnt; //distinct pages sampled
+        int hash_bits;
+        long long *keys; //page number in each bucket, -1 when empty
+        int *slots; //dense index of the page in each bucket
+        long long *page_at; //page number behind each dense index
+    };
+
+struct SHARDS_ESTIMATE {
+        int policy;
+        int frame_cnt;
+        int sampled_frames; //frame_cnt scaled by the rate
+        long long sampled_references;
+        long long sampled_faults;
+        double miss_ratio;
+        double page_faults; //estimated faults over every reference offered
+        double error; //half-width of a 95% confidence interval on page_faults
+    };
+
+struct PREFETCHER {
+        int policy; //one of the PREFETCH_ values
+        int depth; //pages read ahead per trigger, the largest window under PREFETCH_ADAPTIVE
+        int window; //current window under PREFETCH_ADAPTIVE
+        int limit; //window beyond which PREFETCH_ADAPTIVE grows one page at a time
+        int streak; //prefetch hits since the window last grew past the limit
+        int table_cnt;
+        int last_trigger; //page of the last demand fault or prefetch hit, -1 if none
+        int stride; //distance between the last two triggers
+        int *pending; //prefetched pages in memory that have not been referenced yet
+        int *pending_at; //index of each page in pending, -1 if it is not there
+        int pending_cnt;
+        long long demand_faults;
+        long long prefetches; //pages loaded ahead of their reference
+        long long prefetch_hits; //first references to prefetched pages still in memory
+        long long wasted_prefetches; //prefetched pages that left memory unreferenced
+        void *arena;
+    };
+
+struct INSTRUMENT_COUNTERS {
+        long long hits;
+        long long faults;
+        long long prefetches; //pages loaded by page_context_prefetch, not counted as faults
+        long long evictions;
+        long long eviction_age[INSTRUMENT_BUCKETS]; //timestamps from a page's load to its eviction
+        long long reuse_distance[INSTRUMENT_BUCKETS]; //timestamps since the page's previous reference, hit or fault
+        long long runs; //page_context_run calls that returned, including those that failed partway
+        long long run_references;
+        long long run_ns; //wall time spent in those runs
+        long long events; //events written to the log
+        long long dropped_events; //events lost because the log could not be written
+    };
+
+struct INSTRUMENT_EVENT {
+        int type; //one of the INSTRUMENT_EVENT_ values
+        int thread_id; //order in which the thread first recorded anything, from 0
+        int timestamp;
+        int page_number;
+        int frame_number; //-1 for an eviction
+        int value; //reuse distance for a hit or fault and age for an eviction, -1 if not known or a prefetch
     };
 
 
@@ -55,15 +481,133 @@ struct MEMORY_BLOCK first_fit_allocate(int request_size, struct MEMORY_BLOCK mem
 struct MEMORY_BLOCK worst_fit_allocate(int request_size, struct MEMORY_BLOCK memory_map[MAPMAX],int *map_cnt, int process_id);  
 struct MEMORY_BLOCK next_fit_allocate(int request_size, struct MEMORY_BLOCK memory_map[MAPMAX],int *map_cnt, int process_id, int last_address); 
 void release_memory(struct MEMORY_BLOCK freed_block, struct MEMORY_BLOCK memory_map[MAPMAX],int *map_cnt);  
-int process_page_access_fifo(struct PTE page_table[TABLEMAX],int *table_cnt, int page_number, int frame_pool[POOLMAX],int *frame_cnt, int current_timestamp); 
-int count_page_faults_fifo(struct PTE page_table[TABLEMAX],int table_cnt, int refrence_string[REFERENCEMAX],int reference_cnt,int frame_pool[POOLMAX],int frame_cnt);
-int process_page_access_lru(struct PTE page_table[TABLEMAX],int *table_cnt, int page_number, int frame_pool[POOLMAX],int *frame_cnt, int current_timestamp); 
-int count_page_faults_lru(struct PTE page_table[TABLEMAX],int table_cnt, int refrence_string[REFERENCEMAX],int reference_cnt,int frame_pool[POOLMAX],int frame_cnt);
-int process_page_access_lfu(struct PTE page_table[TABLEMAX],int *table_cnt, int page_number, int frame_pool[POOLMAX],int *frame_cnt, int current_timestamp); 
-int count_page_faults_lfu(struct PTE page_table[TABLEMAX],int table_cnt, int refrence_string[REFERENCEMAX],int reference_cnt,int frame_pool[POOLMAX],int frame_cnt);
+int process_page_access_fifo(struct PTE page_table[],int *table_cnt, int page_number, int frame_pool[],int *frame_cnt, int current_timestamp); 
+int count_page_faults_fifo(struct PTE page_table[],int table_cnt, int refrence_string[],int reference_cnt,int frame_pool[],int frame_cnt);
+int process_page_access_lru(struct PTE page_table[],int *table_cnt, int page_number, int frame_pool[],int *frame_cnt, int current_timestamp); 
+int count_page_faults_lru(struct PTE page_table[],int table_cnt, int refrence_string[],int reference_cnt,int frame_pool[],int frame_cnt);
+int process_page_access_lfu(struct PTE page_table[],int *table_cnt, int page_number, int frame_pool[],int *frame_cnt, int current_timestamp); 
+int count_page_faults_lfu(struct PTE page_table[],int table_cnt, int refrence_string[],int reference_cnt,int frame_pool[],int frame_cnt);
 struct PCB handle_process_arrival_pp(struct PCB ready_queue[QUEUEMAX], int *queue_cnt, struct PCB current_process, struct PCB new_process, int timestamp);
 struct PCB handle_process_completion_pp(struct PCB ready_queue[QUEUEMAX], int *queue_cnt, int timestamp);
 struct PCB handle_process_arrival_srtp(struct PCB ready_queue[QUEUEMAX], int *queue_cnt, struct PCB current_process, struct PCB new_process, int time_stamp);
 struct PCB handle_process_completion_srtp(struct PCB ready_queue[QUEUEMAX], int *queue_cnt, int timestamp);
 struct PCB handle_process_arrival_rr(struct PCB ready_queue[QUEUEMAX], int *queue_cnt, struct PCB current_process, struct PCB new_process, int timestamp, int time_quantum);
 struct PCB handle_process_completion_rr(struct PCB ready_queue[QUEUEMAX], int *queue_cnt, int timestamp, int time_quantum);
+int lru_list_init(struct LRU_LIST *list, int prev[], int next[], struct PTE page_table[], int table_cnt);
+void lru_list_push(struct LRU_LIST *list, int page_number);
+void lru_list_unlink(struct LRU_LIST *list, int page_number);
+int lru_list_access(struct LRU_LIST *list, struct PTE page_table[], int page_number, int frame_pool[], int *frame_cnt, int current_timestamp);
+int fifo_list_init(struct LRU_LIST *list, int prev[], int next[], struct PTE page_table[], int table_cnt);
+int fifo_list_access(struct LRU_LIST *list, struct PTE page_table[], int page_number, int frame_pool[], int *frame_cnt, int current_timestamp);
+int lfu_table_init(struct LFU_TABLE *lfu, int heap[], int position[], struct PTE page_table[], int table_cnt);
+int lfu_table_access(struct LFU_TABLE *lfu, struct PTE page_table[], int page_number, int frame_pool[], int *frame_cnt, int current_timestamp);
+size_t arena_size(size_t bytes);
+void *arena_take(struct ARENA *arena, size_t bytes);
+long long monotonic_ns(void);
+unsigned long long xorshift64(unsigned long long *state);
+int clock_list_victim(struct LRU_LIST *list, struct PTE page_table[], int current_timestamp);
+int clock_list_access(struct LRU_LIST *list, struct PTE page_table[], int page_number, int frame_pool[], int *frame_cnt, int current_timestamp);
+int clockpro_init(struct CLOCK_PRO *cp, int next[], int prev[], int type[], int hot_next[], int hot_prev[], int released[], struct PTE page_table[], int table_cnt, int frame_cnt);
+int clockpro_access(struct CLOCK_PRO *cp, struct PTE page_table[], int page_number, int frame_pool[], int *frame_cnt, int current_timestamp);
+int clockpro_prefetch(struct CLOCK_PRO *cp, struct PTE page_table[], int page_number, int frame_pool[], int *frame_cnt, int current_timestamp);
+int process_page_access_clock(struct PTE page_table[],int *table_cnt, int page_number, int frame_pool[],int *frame_cnt, int current_timestamp);
+int count_page_faults_clock(struct PTE page_table[],int table_cnt, int reference_string[],int reference_cnt,int frame_pool[],int frame_cnt);
+int count_page_faults_clockpro(struct PTE page_table[],int table_cnt, int reference_string[],int reference_cnt,int frame_pool[],int frame_cnt);
+int arc_init(struct ARC *arc, int prev[], int next[], int list[], struct PTE page_table[], int table_cnt, int frame_cnt);
+int arc_access(struct ARC *arc, struct PTE page_table[], int page_number, int frame_pool[], int *frame_cnt, int current_timestamp);
+int arc_prefetch(struct ARC *arc, struct PTE page_table[], int page_number, int frame_pool[], int *frame_cnt, int current_timestamp);
+int two_queue_init(struct TWO_QUEUE *tq, int prev[], int next[], int list[], struct PTE page_table[], int table_cnt, int frame_cnt);
+int two_queue_access(struct TWO_QUEUE *tq, struct PTE page_table[], int page_number, int frame_pool[], int *frame_cnt, int current_timestamp);
+int two_queue_prefetch(struct TWO_QUEUE *tq, struct PTE page_table[], int page_number, int frame_pool[], int *frame_cnt, int current_timestamp);
+int count_page_faults_arc(struct PTE page_table[],int table_cnt, int reference_string[],int reference_cnt,int frame_pool[],int frame_cnt);
+int count_page_faults_2q(struct PTE page_table[],int table_cnt, int reference_string[],int reference_cnt,int frame_pool[],int frame_cnt);
+int count_page_faults_opt(struct PTE page_table[],int table_cnt, int reference_string[],int reference_cnt,int frame_pool[],int frame_cnt);
+int pte_table_best_kernel(void);
+struct PTE_TABLE *pte_table_create(int table_cnt);
+void pte_table_destroy(struct PTE_TABLE *pt);
+void pte_table_load(struct PTE_TABLE *pt, struct PTE page_table[]);
+void pte_table_store(struct PTE_TABLE *pt, struct PTE page_table[]);
+int pte_table_victim(struct PTE_TABLE *pt, int policy);
+int process_page_access_soa(struct PTE_TABLE *pt, int policy, int page_number, int frame_pool[], int *frame_cnt, int current_timestamp);
+struct PAGE_CONTEXT *page_context_create(int table_cnt, int pool_cnt, int policy);
+struct PAGE_CONTEXT *page_context_attach(struct PTE page_table[], int table_cnt, int frame_pool[], int frame_cnt, int policy);
+void page_context_view(struct PAGE_CONTEXT *ctx, struct PTE page_table[], int table_cnt, int frame_pool[], int frame_cnt, int policy);
+void page_context_destroy(struct PAGE_CONTEXT *ctx);
+int page_context_reset(struct PAGE_CONTEXT *ctx, int policy, int frame_cnt);
+int page_context_access(struct PAGE_CONTEXT *ctx, int page_number, int current_timestamp);
+int page_context_prefetch(struct PAGE_CONTEXT *ctx, int page_number, int current_timestamp);
+int page_context_run(struct PAGE_CONTEXT *ctx, int reference_string[], int reference_cnt);
+int trace_open(struct TRACE_READER *trace, const char *path, int format);
+int trace_open_fd(struct TRACE_READER *trace, int fd, int format);
+int trace_next(struct TRACE_READER *trace, long long *page_number);
+void trace_close(struct TRACE_READER *trace);
+long long count_page_faults_trace(struct PAGE_CONTEXT *ctx, struct TRACE_READER *trace);
+struct STACK_DISTANCE *stack_distance_create(int table_cnt);
+void stack_distance_destroy(struct STACK_DISTANCE *sd);
+int stack_distance_access(struct STACK_DISTANCE *sd, int page_number);
+int stack_distance_curve(struct STACK_DISTANCE *sd, long long page_faults[], int max_frames);
+int count_page_faults_lru_curve(int reference_string[], int reference_cnt, int table_cnt, long long page_faults[], int max_frames);
+int sweep_run(struct SWEEP_TRACE traces[], int trace_cnt, struct SWEEP_JOB jobs[], int job_cnt, struct SWEEP_RESULT results[], int thread_cnt);
+void sweep_print(FILE *out, struct SWEEP_RESULT results[], int job_cnt);
+struct MEMORY_MANAGER *memory_manager_create(int process_cnt, int table_cnts[], int pool_cnt, int policy, int scope);
+void memory_manager_destroy(struct MEMORY_MANAGER *mm);
+void memory_manager_reset(struct MEMORY_MANAGER *mm);
+int memory_manager_set_quota(struct MEMORY_MANAGER *mm, int process_id, int quota);
+int memory_manager_access(struct MEMORY_MANAGER *mm, int process_id, int page_number, int current_timestamp);
+long long memory_manager_run(struct MEMORY_MANAGER *mm, int process_ids[], int reference_string[], int reference_cnt);
+long long memory_manager_run_trace(struct MEMORY_MANAGER *mm, struct TRACE_READER *trace);
+struct TLB *tlb_create(int entry_cnt, int ways, int policy);
+void tlb_destroy(struct TLB *tlb);
+void tlb_flush(struct TLB *tlb);
+void tlb_reset(struct TLB *tlb);
+int tlb_lookup(struct TLB *tlb, int page_number);
+void tlb_insert(struct TLB *tlb, int page_number, int frame_number);
+int tlb_shootdown(struct TLB *tlb, int page_number);
+int page_context_access_tlb(struct TLB *tlb, struct PAGE_CONTEXT *ctx, int page_number, int current_timestamp);
+int process_page_access_tlb(struct TLB *tlb, int policy, struct PTE page_table[], int *table_cnt, int page_number, int frame_pool[], int *frame_cnt, int current_timestamp);
+int page_context_run_tlb(struct TLB *tlb, struct PAGE_CONTEXT *ctx, int reference_string[], int reference_cnt, long long *tlb_misses);
+struct SPARSE_TABLE *sparse_table_create(int pool_cnt, int policy);
+void sparse_table_destroy(struct SPARSE_TABLE *st);
+void sparse_table_reset(struct SPARSE_TABLE *st);
+struct PTE *sparse_table_lookup(struct SPARSE_TABLE *st, long long page_number);
+int sparse_table_access(struct SPARSE_TABLE *st, long long page_number, int current_timestamp);
+long long sparse_table_run_trace(struct SPARSE_TABLE *st, struct TRACE_READER *trace);
+struct MEMORY_ALLOCATOR *memory_allocator_create(int memory_size, int block_cap);
+void memory_allocator_destroy(struct MEMORY_ALLOCATOR *ma);
+struct MEMORY_BLOCK memory_allocator_allocate(struct MEMORY_ALLOCATOR *ma, int fit, int request_size, int process_id);
+int memory_allocator_release(struct MEMORY_ALLOCATOR *ma, struct MEMORY_BLOCK freed_block);
+int memory_allocator_largest_free(struct MEMORY_ALLOCATOR *ma);
+int memory_allocator_export(struct MEMORY_ALLOCATOR *ma, struct MEMORY_BLOCK memory_map[], int map_cap);
+struct DISK_QUEUE *disk_queue_create(int policy, int capacity);
+void disk_queue_destroy(struct DISK_QUEUE *dq);
+int disk_queue_push(struct DISK_QUEUE *dq, struct RCB request);
+struct RCB disk_queue_pop(struct DISK_QUEUE *dq, int current_cylinder, int scan_direction);
+int disk_replay(int policy, struct RCB requests[], int request_cnt, int start_cylinder, int seek_time, int transfer_time, struct DISK_STATS *stats);
+struct READY_QUEUE *ready_queue_create(int policy, int capacity);
+void ready_queue_destroy(struct READY_QUEUE *rq);
+int ready_queue_push(struct READY_QUEUE *rq, struct PCB process);
+struct PCB ready_queue_arrival(struct READY_QUEUE *rq, struct PCB current_process, struct PCB new_process, int timestamp, int time_quantum);
+struct PCB ready_queue_completion(struct READY_QUEUE *rq, int timestamp, int time_quantum);
+int cpu_replay(int policy, struct PCB processes[], int process_cnt, int time_quantum, struct CPU_STATS *stats);
+int count_page_faults_ws(struct PTE page_table[], int table_cnt, int reference_string[], int reference_cnt, int frame_pool[], int frame_cnt, int window, int phase_length, long long phase_faults[], struct RESIDENT_STATS *stats);
+int count_page_faults_pff(struct PTE page_table[], int table_cnt, int reference_string[], int reference_cnt, int frame_pool[], int frame_cnt, double lower_rate, double upper_rate, int phase_length, long long phase_faults[], struct RESIDENT_STATS *stats);
+struct SHARDS_SAMPLE *shards_create(double rate);
+void shards_destroy(struct SHARDS_SAMPLE *s);
+int shards_add(struct SHARDS_SAMPLE *s, long long page_number);
+long long shards_add_trace(struct SHARDS_SAMPLE *s, struct TRACE_READER *trace);
+int shards_curve(struct SHARDS_SAMPLE *s, int policy, int frame_cnts[], int curve_cnt, struct SHARDS_ESTIMATE estimates[]);
+int shards_estimate(struct SHARDS_SAMPLE *s, int policy, int frame_cnt, struct SHARDS_ESTIMATE *estimate);
+struct PREFETCHER *prefetcher_create(int table_cnt, int policy, int depth);
+void prefetcher_destroy(struct PREFETCHER *pf);
+void prefetcher_reset(struct PREFETCHER *pf);
+int page_context_access_prefetch(struct PREFETCHER *pf, struct PAGE_CONTEXT *ctx, int page_number, int current_timestamp);
+int process_page_access_prefetch(struct PREFETCHER *pf, int policy, struct PTE page_table[], int *table_cnt, int page_number, int frame_pool[], int *frame_cnt, int current_timestamp);
+int page_context_run_prefetch(struct PREFETCHER *pf, struct PAGE_CONTEXT *ctx, int reference_string[], int reference_cnt);
+int instrument_snapshot(struct INSTRUMENT_COUNTERS *total);
+void instrument_reset(void);
+int instrument_log_open(const char *path, int capacity);
+long long instrument_log_close(void);
+void instrument_access(struct PAGE_CONTEXT *ctx, int page_number, int frame_number, int hit, int prefetch, int current_timestamp);
+void instrument_evict(struct PAGE_CONTEXT *ctx, int page_number, int current_timestamp);
+void instrument_run_begin(void);
+void instrument_run_end(int reference_cnt);
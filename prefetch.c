@@ -0,0 +1,252 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <limits.h>
+#include "oslabs.h"
+
+/*A PREFETCHER adds a readahead stage to the fault path of a PAGE_CONTEXT. The stage runs on a demand
+fault and on the first reference to a page it prefetched, so a sequential scan that keeps hitting its
+readahead keeps it going and stops faulting. PREFETCH_NEXT_N reads the depth pages after the trigger.
+PREFETCH_STRIDE waits until two triggers in a row are the same distance apart and then reads depth pages
+ahead along that stride. PREFETCH_ADAPTIVE reads a window after the trigger that is sized the way TCP
+sizes its congestion window. While the stream stays sequential the window doubles up to a limit and
+then grows by one page for every window of prefetch hits, up to depth. A prefetched page that leaves
+memory unused means the readahead outran the frames, so the limit and the window drop to half the
+window. A fault that breaks the stream closes the window but keeps the limit.
+
+Prefetched pages are loaded through page_context_prefetch, so they take free frames and replace pages
+like any other, but the policy sees them as not yet referenced: they are not faults, they raise no
+ghost hits and no adaptation in ARC, 2Q or CLOCK-Pro, and their first reference counts the way a
+demand fault's load would. The readahead goes in before the access that triggered it, on a prefetch hit
+as on a fault, so the frame returned always holds the page. A prefetch hit's readahead that pushes its
+own trigger out has outrun the frames: it stops there, the trigger counts as wasted and the reference
+faults it back in. The context's page_faults then counts demand faults only. Prefetched pages not
+yet referenced are kept in a pending set, which tells prefetch hits apart and catches the ones evicted
+unused.*/
+
+static int valid_prefetch_policy(int policy)
+{
+    return policy == PREFETCH_NONE || policy == PREFETCH_NEXT_N || policy == PREFETCH_STRIDE || policy == PREFETCH_ADAPTIVE;
+}
+
+static void pending_remove(struct PREFETCHER *pf, int page_number)
+{
+    int at = pf->pending_at[page_number];
+    int last = pf->pending[--pf->pending_cnt];
+
+    pf->pending[at] = last;
+    pf->pending_at[last] = at;
+    pf->pending_at[page_number] = -1;
+}
+
+static void prefetch_wasted(struct PREFETCHER *pf, int page_number)
+{
+    pending_remove(pf, page_number);
+    pf->wasted_prefetches += 1;
+    if(pf->policy == PREFETCH_ADAPTIVE){
+        pf->limit = MAX(1, pf->window / 2); //reading too far ahead for the frames there are
+        pf->window = pf->limit;
+        pf->streak = 0;
+    }
+}
+
+static void prefetch_evicted(struct PREFETCHER *pf, struct PAGE_CONTEXT *ctx)
+{
+    //counts the page the last access moved out of memory if it was prefetched and never referenced
+    if(ctx->evicted_page != -1 && pf->pending_at[ctx->evicted_page] != -1){
+        prefetch_wasted(pf, ctx->evicted_page);
+    }
+}
+
+static int prefetch_load(struct PREFETCHER *pf, struct PAGE_CONTEXT *ctx, int page_number, int current_timestamp)
+{
+    //brings the page in ahead of its reference unless it is already in memory
+    if(ctx->page_table[page_number].is_valid != 0){
+        return 0;
+    }
+    if(page_context_prefetch(ctx, page_number, current_timestamp) == -1){
+        return -1;
+    }
+    prefetch_evicted(pf, ctx);
+    pf->pending_at[page_number] = pf->pending_cnt;
+    pf->pending[pf->pending_cnt++] = page_number;
+    pf->prefetches += 1;
+    return 0;
+}
+
+static int prefetch_stage(struct PREFETCHER *pf, struct PAGE_CONTEXT *ctx, int page_number, int current_timestamp, int hit)
+{
+    //decides how far to read ahead of the trigger page and loads those pages
+    int step = 1;
+    int count = 0;
+
+    switch(pf->policy){
+    case PREFETCH_NEXT_N:
+        count = pf->depth;
+        break;
+    case PREFETCH_STRIDE:
+        if(pf->last_trigger != -1){
+            if(pf->stride != 0 && page_number - pf->last_trigger == pf->stride){
+                step = pf->stride;
+                count = pf->depth;
+            }
+            pf->stride = page_number - pf->last_trigger;
+        }
+        break;
+    case PREFETCH_ADAPTIVE:
+        if(pf->window < pf->limit && (hit || (pf->last_trigger != -1 && page_number == pf->last_trigger + 1))){
+            pf->window = MIN(pf->limit, MAX(1, 2 * pf->window));
+        }
+        else if(hit && ++pf->streak >= pf->window){
+            pf->window = MIN(pf->depth, pf->window + 1);
+            pf->limit = MAX(pf->limit, pf->window);
+            pf->streak = 0;
+        }
+        else if(!hit && (pf->last_trigger == -1 || page_number != pf->last_trigger + 1)){
+            pf->window = 0; //not a stream, or not yet
+        }
+        count = pf->window;
+        break;
+    }
+    pf->last_trigger = page_number;
+    for(int k = 1; k <= count; k++){
+        long long target = page_number + (long long)k * step;
+
+        if(target < 0 || target >= ctx->table_cnt){
+            break;
+        }
+        if(prefetch_load(pf, ctx, (int)target, current_timestamp) == -1){
+            return -1;
+        }
+        if(hit && ctx->page_table[page_number].is_valid == 0){
+            break; //outran the frames and pushed out the page that triggered it
+        }
+    }
+    return 0;
+}
+
+struct PREFETCHER *prefetcher_create(int table_cnt, int policy, int depth)
+{
+    /*Creates a prefetcher for page tables of up to table_cnt pages that reads ahead by policy, one of
+the PREFETCH_ values, up to depth pages per trigger. Returns NULL if table_cnt is not positive, the
+policy is unknown, depth is not positive for a policy that reads ahead or the arena cannot be
+allocated.*/
+    struct ARENA arena;
+    struct PREFETCHER *pf;
+
+    if(table_cnt <= 0 || !valid_prefetch_policy(policy) || (policy != PREFETCH_NONE && depth <= 0)){
+        return NULL;
+    }
+    arena.base = malloc(arena_size(sizeof(struct PREFETCHER)) + 2 * arena_size((size_t)table_cnt * sizeof(int)));
+    arena.used = 0;
+    if(arena.base == NULL){
+        return NULL;
+    }
+    pf = arena_take(&arena, sizeof(struct PREFETCHER));
+    pf->arena = arena.base;
+    pf->policy = policy;
+    pf->depth = policy != PREFETCH_NONE ? depth : 0;
+    pf->table_cnt = table_cnt;
+    pf->pending = arena_take(&arena, (size_t)table_cnt * sizeof(int));
+    pf->pending_at = arena_take(&arena, (size_t)table_cnt * sizeof(int));
+    for(int i = 0; i < table_cnt; i++){
+        pf->pending_at[i] = -1;
+    }
+    pf->pending_cnt = 0;
+    prefetcher_reset(pf);
+    return pf;
+}
+
+void prefetcher_destroy(struct PREFETCHER *pf)
+{
+    if(pf != NULL){
+        free(pf->arena); //the prefetcher itself lives in the arena
+    }
+}
+
+void prefetcher_reset(struct PREFETCHER *pf)
+{
+    //forgets the stream and the pending pages and starts the counters over, for a context that was reset
+    for(int i = 0; i < pf->pending_cnt; i++){
+        pf->pending_at[pf->pending[i]] = -1;
+    }
+    pf->pending_cnt = 0;
+    pf->window = 0;
+    pf->limit = pf->depth;
+    pf->streak = 0;
+    pf->last_trigger = -1;
+    pf->stride = 0;
+    pf->demand_faults = 0;
+    pf->prefetches = 0;
+    pf->prefetch_hits = 0;
+    pf->wasted_prefetches = 0;
+}
+
+int page_context_access_prefetch(struct PREFETCHER *pf, struct PAGE_CONTEXT *ctx, int page_number, int current_timestamp)
+{
+    /*Same as page_context_access with the prefetch stage on the fault path. The context must only be
+accessed through the prefetcher, so that it sees every page leave memory. Returns -1 under the same
+conditions as page_context_access, when a prefetch fails or when the page table is larger than the
+prefetcher's.*/
+    int frame_number;
+    int resident;
+
+    if(page_number < 0 || page_number >= ctx->table_cnt || ctx->table_cnt > pf->table_cnt){
+        return -1;
+    }
+    resident = ctx->page_table[page_number].is_valid != 0;
+    if(!resident || pf->pending_at[page_number] != -1){
+        if(prefetch_stage(pf, ctx, page_number, current_timestamp, resident) == -1){
+            return -1;
+        }
+        resident = ctx->page_table[page_number].is_valid != 0; //a prefetch hit's readahead may have pushed it out
+    }
+    frame_number = page_context_access(ctx, page_number, current_timestamp);
+    if(frame_number == -1){
+        return -1;
+    }
+    if(resident){
+        if(pf->pending_at[page_number] != -1){
+            pending_remove(pf, page_number);
+            pf->prefetch_hits += 1;
+        }
+        return frame_number;
+    }
+    prefetch_evicted(pf, ctx);
+    pf->demand_faults += 1;
+    return frame_number;
+}
+
+int process_page_access_prefetch(struct PREFETCHER *pf,
+int policy,
+struct PTE page_table[],
+int *table_cnt,
+int page_number,
+int frame_pool[],
+int *frame_cnt,
+int current_timestamp)
+{
+    /*Same as process_page_access_fifo, _lru, _lfu or _clock, picked by policy, with the prefetch stage
+on the fault path. The prefetcher must only ever be used with this page table.*/
+    struct PAGE_CONTEXT view;
+    int frame_number;
+
+    page_context_view(&view, page_table, *table_cnt, frame_pool, *frame_cnt, policy);
+    frame_number = page_context_access_prefetch(pf, &view, page_number, current_timestamp);
+    *frame_cnt = view.frame_cnt; //prefetches and the fault may have taken frames from the pool
+    return frame_number;
+}
+
+int page_context_run_prefetch(struct PREFETCHER *pf, struct PAGE_CONTEXT *ctx, int reference_string[], int reference_cnt)
+{
+    /*Same as page_context_run through the prefetcher. Returns the number of demand faults in this run,
+or -1 if an access fails or the timestamp reaches INT_MAX.*/
+    long long page_faults = ctx->page_faults;
+
+    for(int i = 0; i < reference_cnt; i++){
+        if(ctx->timestamp == INT_MAX || page_context_access_prefetch(pf, ctx, reference_string[i], ctx->timestamp) == -1){
+            return -1;
+        }
+        ctx->timestamp += 1;
+    }
+    return (int)(ctx->page_faults - page_faults);
+}
@@ -0,0 +1,352 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <limits.h>
+#include "oslabs.h"
+
+/*A PTE_TABLE is a page table stored as a structure of arrays: every field of struct PTE has its own
+contiguous array indexed by page number. A victim search compares one field (two for LFU) across the
+table, so it only streams the arrays it needs through the cache instead of whole 24-byte entries, and
+the comparisons vectorize.
+
+Every search is a masked min-reduction in two steps: first the smallest key among the pages in memory,
+then the lowest page number holding that key. That matches the linear scan of the process_page_access
+functions, which keeps the first smallest entry it meets. The kernels come in scalar, SSE4.1 (4 pages
+per step) and AVX2 (8 pages per step) versions. pte_table_create picks the widest one the processor
+supports, and building with OSLABS_NO_SIMD defined leaves only the scalar one.*/
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)) && !defined(OSLABS_NO_SIMD)
+#define PTE_SIMD 1
+#include <immintrin.h>
+#else
+#define PTE_SIMD 0
+#endif
+
+static int masked_min_scalar(const int valid[], const int key[], const int filter[], int filter_value, int table_cnt)
+{
+    /*Smallest key[i] over the pages with valid[i] set and, when filter is not NULL, filter[i] equal to
+filter_value. INT_MAX if there are none. Entries are masked with arithmetic instead of being skipped
+with a branch, since whether a page is in memory is as good as random on a busy table.*/
+    int best = INT_MAX;
+
+    for(int i = 0; i < table_cnt; i++){
+        int keep = -((valid[i] != 0) & (filter == NULL || filter[i] == filter_value)); //all ones for pages that count
+        int candidate = (key[i] & keep) | (INT_MAX & ~keep);
+        best = candidate < best ? candidate : best;
+    }
+    return best;
+}
+
+static int masked_find_scalar(const int valid[], const int key[], int key_value, const int filter[], int filter_value, int table_cnt)
+{
+    //lowest page with valid[i] set, key[i] equal to key_value and the filter passing, -1 if none
+    for(int i = 0; i < table_cnt; i++){
+        unsigned miss = (unsigned)(key[i] ^ key_value) | (unsigned)(valid[i] == 0);
+        if(filter != NULL){
+            miss |= (unsigned)(filter[i] ^ filter_value);
+        }
+        if(miss == 0){
+            return i;
+        }
+    }
+    return -1;
+}
+
+#if PTE_SIMD
+__attribute__((target("sse4.1")))
+static int masked_min_sse41(const int valid[], const int key[], const int filter[], int filter_value, int table_cnt)
+{
+    __m128i zero = _mm_setzero_si128();
+    __m128i wanted = _mm_set1_epi32(filter_value);
+    __m128i best = _mm_set1_epi32(INT_MAX);
+    int i = 0;
+    int result;
+
+    for(; i + 4 <= table_cnt; i += 4){
+        __m128i skip = _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i *)(valid + i)), zero);
+        __m128i keys = _mm_loadu_si128((const __m128i *)(key + i));
+        if(filter != NULL){
+            skip = _mm_or_si128(skip, _mm_xor_si128(_mm_cmpeq_epi32(_mm_loadu_si128((const __m128i *)(filter + i)), wanted),
+                _mm_set1_epi32(-1)));
+        }
+        best = _mm_min_epi32(best, _mm_blendv_epi8(keys, _mm_set1_epi32(INT_MAX), skip));
+    }
+    best = _mm_min_epi32(best, _mm_shuffle_epi32(best, _MM_SHUFFLE(1, 0, 3, 2)));
+    best = _mm_min_epi32(best, _mm_shuffle_epi32(best, _MM_SHUFFLE(2, 3, 0, 1)));
+    result = _mm_cvtsi128_si32(best);
+    return MIN(result, masked_min_scalar(valid + i, key + i, filter != NULL ? filter + i : NULL, filter_value, table_cnt - i));
+}
+
+__attribute__((target("sse4.1")))
+static int masked_find_sse41(const int valid[], const int key[], int key_value, const int filter[], int filter_value, int table_cnt)
+{
+    __m128i zero = _mm_setzero_si128();
+    __m128i wanted = _mm_set1_epi32(filter_value);
+    __m128i target = _mm_set1_epi32(key_value);
+    int i = 0;
+    int found;
+
+    for(; i + 4 <= table_cnt; i += 4){
+        __m128i hit = _mm_andnot_si128(_mm_cmpeq_epi32(_mm_loadu_si128((const __m128i *)(valid + i)), zero),
+            _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i *)(key + i)), target));
+        int mask;
+        if(filter != NULL){
+            hit = _mm_and_si128(hit, _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i *)(filter + i)), wanted));
+        }
+        mask = _mm_movemask_ps(_mm_castsi128_ps(hit));
+        if(mask != 0){
+            return i + __builtin_ctz(mask);
+        }
+    }
+    found = masked_find_scalar(valid + i, key + i, key_value, filter != NULL ? filter + i : NULL, filter_value, table_cnt - i);
+    return found == -1 ? -1 : i + found;
+}
+
+__attribute__((target("avx2")))
+static int masked_min_avx2(const int valid[], const int key[], const int filter[], int filter_value, int table_cnt)
+{
+    __m256i zero = _mm256_setzero_si256();
+    __m256i wanted = _mm256_set1_epi32(filter_value);
+    __m256i best = _mm256_set1_epi32(INT_MAX);
+    __m128i half;
+    int i = 0;
+    int result;
+
+    for(; i + 8 <= table_cnt; i += 8){
+        __m256i skip = _mm256_cmpeq_epi32(_mm256_loadu_si256((const __m256i *)(valid + i)), zero);
+        __m256i keys = _mm256_loadu_si256((const __m256i *)(key + i));
+        if(filter != NULL){
+            skip = _mm256_or_si256(skip, _mm256_xor_si256(_mm256_cmpeq_epi32(_mm256_loadu_si256((const __m256i *)(filter + i)), wanted),
+                _mm256_set1_epi32(-1)));
+        }
+        best = _mm256_min_epi32(best, _mm256_blendv_epi8(keys, _mm256_set1_epi32(INT_MAX), skip));
+    }
+    half = _mm_min_epi32(_mm256_castsi256_si128(best), _mm256_extracti128_si256(best, 1));
+    half = _mm_min_epi32(half, _mm_shuffle_epi32(half, _MM_SHUFFLE(1, 0, 3, 2)));
+    half = _mm_min_epi32(half, _mm_shuffle_epi32(half, _MM_SHUFFLE(2, 3, 0, 1)));
+    result = _mm_cvtsi128_si32(half);
+    return MIN(result, masked_min_scalar(valid + i, key + i, filter != NULL ? filter + i : NULL, filter_value, table_cnt - i));
+}
+
+__attribute__((target("avx2")))
+static int masked_find_avx2(const int valid[], const int key[], int key_value, const int filter[], int filter_value, int table_cnt)
+{
+    __m256i zero = _mm256_setzero_si256();
+    __m256i wanted = _mm256_set1_epi32(filter_value);
+    __m256i target = _mm256_set1_epi32(key_value);
+    int i = 0;
+    int found;
+
+    for(; i + 8 <= table_cnt; i += 8){
+        __m256i hit = _mm256_andnot_si256(_mm256_cmpeq_epi32(_mm256_loadu_si256((const __m256i *)(valid + i)), zero),
+            _mm256_cmpeq_epi32(_mm256_loadu_si256((const __m256i *)(key + i)), target));
+        int mask;
+        if(filter != NULL){
+            hit = _mm256_and_si256(hit, _mm256_cmpeq_epi32(_mm256_loadu_si256((const __m256i *)(filter + i)), wanted));
+        }
+        mask = _mm256_movemask_ps(_mm256_castsi256_ps(hit));
+        if(mask != 0){
+            return i + __builtin_ctz(mask);
+        }
+    }
+    found = masked_find_scalar(valid + i, key + i, key_value, filter != NULL ? filter + i : NULL, filter_value, table_cnt - i);
+    return found == -1 ? -1 : i + found;
+}
+#endif
+
+static int masked_min(int kernel, const int valid[], const int key[], const int filter[], int filter_value, int table_cnt)
+{
+#if PTE_SIMD
+    if(kernel == PTE_KERNEL_AVX2){
+        return masked_min_avx2(valid, key, filter, filter_value, table_cnt);
+    }
+    if(kernel == PTE_KERNEL_SSE41){
+        return masked_min_sse41(valid, key, filter, filter_value, table_cnt);
+    }
+#endif
+    (void)kernel;
+    return masked_min_scalar(valid, key, filter, filter_value, table_cnt);
+}
+
+static int masked_find(int kernel, const int valid[], const int key[], int key_value, const int filter[], int filter_value, int table_cnt)
+{
+#if PTE_SIMD
+    if(kernel == PTE_KERNEL_AVX2){
+        return masked_find_avx2(valid, key, key_value, filter, filter_value, table_cnt);
+    }
+    if(kernel == PTE_KERNEL_SSE41){
+        return masked_find_sse41(valid, key, key_value, filter, filter_value, table_cnt);
+    }
+#endif
+    (void)kernel;
+    return masked_find_scalar(valid, key, key_value, filter, filter_value, table_cnt);
+}
+
+int pte_table_best_kernel(void)
+{
+    //widest victim-search kernel this build and processor can run
+#if PTE_SIMD
+    __builtin_cpu_init();
+    if(__builtin_cpu_supports("avx2")){
+        return PTE_KERNEL_AVX2;
+    }
+    if(__builtin_cpu_supports("sse4.1")){
+        return PTE_KERNEL_SSE41;
+    }
+#endif
+    return PTE_KERNEL_SCALAR;
+}
+
+struct PTE_TABLE *pte_table_create(int table_cnt)
+{
+    /*Creates a table of table_cnt invalid entries with every field but is_valid and reference_bit set
+to -1, using the best kernel. Returns NULL if table_cnt is not positive or the arena cannot be
+allocated.*/
+    struct ARENA arena;
+    struct PTE_TABLE *pt;
+    size_t column = arena_size((size_t)table_cnt * sizeof(int));
+
+    if(table_cnt <= 0){
+        return NULL;
+    }
+    arena.base = malloc(arena_size(sizeof(struct PTE_TABLE)) + 6 * column);
+    arena.used = 0;
+    if(arena.base == NULL){
+        return NULL;
+    }
+    pt = arena_take(&arena, sizeof(struct PTE_TABLE));
+    pt->arena = arena.base;
+    pt->table_cnt = table_cnt;
+    pt->kernel = pte_table_best_kernel();
+    pt->is_valid = arena_take(&arena, column);
+    pt->frame_number = arena_take(&arena, column);
+    pt->arrival_timestamp = arena_take(&arena, column);
+    pt->last_access_timestamp = arena_take(&arena, column);
+    pt->reference_count = arena_take(&arena, column);
+    pt->reference_bit = arena_take(&arena, column);
+    for(int i = 0; i < table_cnt; i++){
+        pt->is_valid[i] = 0;
+        pt->frame_number[i] = -1;
+        pt->arrival_timestamp[i] = -1;
+        pt->last_access_timestamp[i] = -1;
+        pt->reference_count[i] = -1;
+        pt->reference_bit[i] = 0;
+    }
+    return pt;
+}
+
+void pte_table_destroy(struct PTE_TABLE *pt)
+{
+    if(pt != NULL){
+        free(pt->arena); //the table itself lives in the arena
+    }
+}
+
+void pte_table_load(struct PTE_TABLE *pt, struct PTE page_table[])
+{
+    //copies table_cnt entries of an array of struct PTE into the columns
+    for(int i = 0; i < pt->table_cnt; i++){
+        pt->is_valid[i] = page_table[i].is_valid;
+        pt->frame_number[i] = page_table[i].frame_number;
+        pt->arrival_timestamp[i] = page_table[i].arrival_timestamp;
+        pt->last_access_timestamp[i] = page_table[i].last_access_timestamp;
+        pt->reference_count[i] = page_table[i].reference_count;
+        pt->reference_bit[i] = page_table[i].reference_bit;
+    }
+}
+
+void pte_table_store(struct PTE_TABLE *pt, struct PTE page_table[])
+{
+    //copies the columns back into table_cnt entries of an array of struct PTE
+    for(int i = 0; i < pt->table_cnt; i++){
+        page_table[i].is_valid = pt->is_valid[i];
+        page_table[i].frame_number = pt->frame_number[i];
+        page_table[i].arrival_timestamp = pt->arrival_timestamp[i];
+        page_table[i].last_access_timestamp = pt->last_access_timestamp[i];
+        page_table[i].reference_count = pt->reference_count[i];
+        page_table[i].reference_bit = pt->reference_bit[i];
+    }
+}
+
+int pte_table_victim(struct PTE_TABLE *pt, int policy)
+{
+    /*The page process_page_access_soa replaces under policy: the smallest arrival_timestamp for FIFO,
+the smallest last_access_timestamp for LRU and the smallest reference_count for LFU, with the
+smallest arrival_timestamp breaking LFU ties and the lowest page number breaking any that remain.
+As in the scan, a prefetched page with a reference_count of 0 ranks with the pages referenced once,
+which takes a second pass over those with a count of 1. Returns -1 if no page is in memory or the
+policy is not FIFO, LRU or LFU.*/
+    int count;
+    int arrival;
+    int last_access;
+    int victim;
+    int once;
+
+    switch(policy){
+    case POLICY_FIFO:
+        arrival = masked_min(pt->kernel, pt->is_valid, pt->arrival_timestamp, NULL, 0, pt->table_cnt);
+        return masked_find(pt->kernel, pt->is_valid, pt->arrival_timestamp, arrival, NULL, 0, pt->table_cnt);
+    case POLICY_LRU:
+        last_access = masked_min(pt->kernel, pt->is_valid, pt->last_access_timestamp, NULL, 0, pt->table_cnt);
+        return masked_find(pt->kernel, pt->is_valid, pt->last_access_timestamp, last_access, NULL, 0, pt->table_cnt);
+    case POLICY_LFU:
+        count = masked_min(pt->kernel, pt->is_valid, pt->reference_count, NULL, 0, pt->table_cnt);
+        arrival = masked_min(pt->kernel, pt->is_valid, pt->arrival_timestamp, pt->reference_count, count, pt->table_cnt);
+        if(count == 0){
+            arrival = MIN(arrival, masked_min(pt->kernel, pt->is_valid, pt->arrival_timestamp, pt->reference_count, 1, pt->table_cnt));
+            victim = masked_find(pt->kernel, pt->is_valid, pt->arrival_timestamp, arrival, pt->reference_count, 0, pt->table_cnt);
+            once = masked_find(pt->kernel, pt->is_valid, pt->arrival_timestamp, arrival, pt->reference_count, 1, pt->table_cnt);
+            return victim == -1 || (once != -1 && once < victim) ? once : victim;
+        }
+        return masked_find(pt->kernel, pt->is_valid, pt->arrival_timestamp, arrival, pt->reference_count, count, pt->table_cnt);
+    }
+    return -1;
+}
+
+int process_page_access_soa(struct PTE_TABLE *pt,
+int policy,
+int page_number,
+int frame_pool[],
+int *frame_cnt,
+int current_timestamp)
+{
+    /*Same contract as process_page_access_fifo, process_page_access_lru or process_page_access_lfu,
+chosen by policy, on a structure-of-arrays page table. Returns -1 if page_number is outside the
+table, the policy is not FIFO, LRU or LFU, or there is neither a free frame nor a page in memory to
+replace.*/
+    int victim;
+
+    if(page_number < 0 || page_number >= pt->table_cnt
+        || (policy != POLICY_FIFO && policy != POLICY_LRU && policy != POLICY_LFU)){
+        return -1;
+    }
+    if(pt->is_valid[page_number] != 0){
+        pt->reference_count[page_number] += 1; //update reference count
+        pt->reference_bit[page_number] = 1;
+        pt->last_access_timestamp[page_number] = current_timestamp; //update time
+        return pt->frame_number[page_number];
+    }
+    if(*frame_cnt > 0){
+        *frame_cnt -= 1; //lowers frame count
+        pt->frame_number[page_number] = frame_pool[*frame_cnt];
+    }
+    else {
+        victim = pte_table_victim(pt, policy);
+        if(victim == -1){
+            return -1;
+        }
+        pt->frame_number[page_number] = pt->frame_number[victim]; //replaces the page in memory
+
+        pt->frame_number[victim] = -1;
+        pt->is_valid[victim] = 0;
+        pt->arrival_timestamp[victim] = -1;
+        pt->last_access_timestamp[victim] = -1;
+        pt->reference_count[victim] = -1;
+        pt->reference_bit[victim] = 0;
+    }
+    pt->is_valid[page_number] = 1; //moved to memory so it is valid
+    pt->arrival_timestamp[page_number] = current_timestamp;
+    pt->last_access_timestamp[page_number] = current_timestamp;
+    pt->reference_count[page_number] = 1;
+    pt->reference_bit[page_number] = 1;
+    return pt->frame_number[page_number];
+}
@@ -0,0 +1,150 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "oslabs.h"
+
+/*Replays a disk request trace under FCFS, SSTF and LOOK and prints, for each, the seek distance, the
+mean and worst response time, the throughput in requests per 1000 time units and the scheduler's cost
+in ns/request.
+
+    disk_replay [--trace FILE] [--requests N] [--cylinders N] [--gap N] [--seek-time N] [--transfer-time N] [--seed N]
+
+A trace file holds one request per line as request_id arrival_timestamp cylinder address process_id.
+Without one, --requests requests arrive on average every --gap time units at uniformly random
+cylinders.*/
+
+#define POLICY_CNT 3
+
+static const char *policy_names[POLICY_CNT] = { "FCFS", "SSTF", "LOOK" };
+
+static unsigned long long rng_state = XORSHIFT64_SEED;
+
+static int compare_arrivals(const void *a, const void *b)
+{
+    //arrival order, ties kept in request_id order
+    const struct RCB *x = a;
+    const struct RCB *y = b;
+
+    if(x->arrival_timestamp != y->arrival_timestamp){
+        return (x->arrival_timestamp > y->arrival_timestamp) - (x->arrival_timestamp < y->arrival_timestamp);
+    }
+    return (x->request_id > y->request_id) - (x->request_id < y->request_id);
+}
+
+static struct RCB *read_trace(const char *path, int *request_cnt)
+{
+    FILE *in = fopen(path, "r");
+    struct RCB *requests = NULL;
+    struct RCB request;
+    int capacity = 0;
+
+    *request_cnt = 0;
+    if(in == NULL){
+        return NULL;
+    }
+    while(fscanf(in, "%d %d %d %d %d", &request.request_id, &request.arrival_timestamp, &request.cylinder,
+        &request.address, &request.process_id) == 5){
+        if(*request_cnt == capacity){
+            struct RCB *grown;
+
+            capacity = capacity == 0 ? 4096 : capacity * 2;
+            grown = realloc(requests, (size_t)capacity * sizeof(struct RCB));
+            if(grown == NULL){
+                free(requests);
+                fclose(in);
+                return NULL;
+            }
+            requests = grown;
+        }
+        requests[(*request_cnt)++] = request;
+    }
+    fclose(in);
+    return requests;
+}
+
+static struct RCB *make_trace(int request_cnt, int cylinder_cnt, int gap)
+{
+    struct RCB *requests = malloc((size_t)MAX(1, request_cnt) * sizeof(struct RCB));
+    long long arrival = 1;
+
+    if(requests == NULL){
+        return NULL;
+    }
+    for(int i = 0; i < request_cnt; i++){
+        arrival += (long long)(xorshift64(&rng_state) % (unsigned long long)(2 * gap + 1));
+        requests[i].request_id = i + 1;
+        requests[i].arrival_timestamp = (int)MIN(arrival, 2147483647LL);
+        requests[i].cylinder = (int)(xorshift64(&rng_state) % (unsigned long long)cylinder_cnt);
+        requests[i].address = (int)(xorshift64(&rng_state) % 512);
+        requests[i].process_id = 1 + (int)(xorshift64(&rng_state) % 64);
+    }
+    return requests;
+}
+
+int main(int argc, char *argv[])
+{
+    const char *trace = NULL;
+    int request_cnt = 1000000;
+    int cylinder_cnt = 10000;
+    int gap = 10;
+    int seek_time = 1;
+    int transfer_time = 5;
+    struct RCB *requests;
+
+    for(int i = 1; i < argc; i++){
+        if(strcmp(argv[i], "--trace") == 0 && i + 1 < argc){
+            trace = argv[++i];
+        }
+        else if(strcmp(argv[i], "--requests") == 0 && i + 1 < argc){
+            request_cnt = atoi(argv[++i]);
+        }
+        else if(strcmp(argv[i], "--cylinders") == 0 && i + 1 < argc){
+            cylinder_cnt = atoi(argv[++i]);
+        }
+        else if(strcmp(argv[i], "--gap") == 0 && i + 1 < argc){
+            gap = atoi(argv[++i]);
+        }
+        else if(strcmp(argv[i], "--seek-time") == 0 && i + 1 < argc){
+            seek_time = atoi(argv[++i]);
+        }
+        else if(strcmp(argv[i], "--transfer-time") == 0 && i + 1 < argc){
+            transfer_time = atoi(argv[++i]);
+        }
+        else if(strcmp(argv[i], "--seed") == 0 && i + 1 < argc){
+            rng_state = strtoull(argv[++i], NULL, 10) | 1;
+        }
+        else {
+            fprintf(stderr, "usage: %s [--trace FILE] [--requests N] [--cylinders N] [--gap N] [--seek-time N] [--transfer-time N] [--seed N]\n", argv[0]);
+            return 2;
+        }
+    }
+    if(request_cnt < 0 || cylinder_cnt <= 0 || gap < 0 || seek_time < 0 || transfer_time < 0){
+        fprintf(stderr, "%s: --cylinders must be positive and the other counts and times not negative\n", argv[0]);
+        return 2;
+    }
+    requests = trace != NULL ? read_trace(trace, &request_cnt) : make_trace(request_cnt, cylinder_cnt, gap);
+    if(requests == NULL){
+        fprintf(stderr, "%s: cannot %s\n", argv[0], trace != NULL ? "read the trace" : "allocate the trace");
+        return 1;
+    }
+    qsort(requests, (size_t)request_cnt, sizeof(struct RCB), compare_arrivals);
+    printf("%-6s %9s %14s %10s %12s %12s %10s %10s\n", "policy", "requests", "seek", "mean seek", "mean resp", "max resp",
+        "req/1000t", "ns/req");
+    for(int policy = 0; policy < POLICY_CNT; policy++){
+        struct DISK_STATS stats;
+
+        if(disk_replay(policy, requests, request_cnt, 0, seek_time, transfer_time, &stats) != 0){
+            fprintf(stderr, "%s: %s replay failed\n", argv[0], policy_names[policy]);
+            free(requests);
+            return 1;
+        }
+        printf("%-6s %9lld %14lld %10.1f %12.1f %12lld %10.2f %10.1f\n", policy_names[policy], stats.requests, stats.seek_distance,
+            stats.requests > 0 ? (double)stats.seek_distance / stats.requests : 0.0,
+            stats.requests > 0 ? (double)stats.total_response / stats.requests : 0.0, stats.max_response,
+            stats.makespan > 0 ? 1000.0 * stats.requests / stats.makespan : 0.0,
+            stats.requests > 0 ? (double)stats.elapsed_ns / stats.requests : 0.0);
+        fflush(stdout);
+    }
+    free(requests);
+    return 0;
+}
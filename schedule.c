@@ -0,0 +1,152 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "oslabs.h"
+
+/*Replays a process trace under PP, SRTP and RR and prints, for each, the number of dispatches, the
+mean turnaround and mean and worst waiting time, and the scheduler's cost in ns/process.
+
+    cpu_replay [--trace FILE] [--processes N] [--gap N] [--burst N] [--priorities N] [--quantum N] [--seed N]
+
+A trace file holds one process per line as process_id arrival_timestamp total_bursttime
+process_priority. Without one, --processes processes arrive on average every --gap time units with
+bursts uniform in 1 to --burst and priorities uniform in 1 to --priorities.*/
+
+#define POLICY_CNT 3
+
+static const char *policy_names[POLICY_CNT] = { "PP", "SRTP", "RR" };
+
+static unsigned long long rng_state = XORSHIFT64_SEED;
+
+static int compare_arrivals(const void *a, const void *b)
+{
+    //arrival order, ties kept in process_id order
+    const struct PCB *x = a;
+    const struct PCB *y = b;
+
+    if(x->arrival_timestamp != y->arrival_timestamp){
+        return (x->arrival_timestamp > y->arrival_timestamp) - (x->arrival_timestamp < y->arrival_timestamp);
+    }
+    return (x->process_id > y->process_id) - (x->process_id < y->process_id);
+}
+
+static struct PCB *read_trace(const char *path, int *process_cnt)
+{
+    FILE *in = fopen(path, "r");
+    struct PCB *processes = NULL;
+    struct PCB process;
+    int capacity = 0;
+
+    *process_cnt = 0;
+    if(in == NULL){
+        return NULL;
+    }
+    memset(&process, 0, sizeof(process));
+    while(fscanf(in, "%d %d %d %d", &process.process_id, &process.arrival_timestamp, &process.total_bursttime,
+        &process.process_priority) == 4){
+        if(*process_cnt == capacity){
+            struct PCB *grown;
+
+            capacity = capacity == 0 ? 4096 : capacity * 2;
+            grown = realloc(processes, (size_t)capacity * sizeof(struct PCB));
+            if(grown == NULL){
+                free(processes);
+                fclose(in);
+                return NULL;
+            }
+            processes = grown;
+        }
+        process.remaining_bursttime = process.total_bursttime;
+        processes[(*process_cnt)++] = process;
+    }
+    fclose(in);
+    return processes;
+}
+
+static struct PCB *make_trace(int process_cnt, int gap, int burst, int priority_cnt)
+{
+    struct PCB *processes = malloc((size_t)MAX(1, process_cnt) * sizeof(struct PCB));
+    long long arrival = 1;
+
+    if(processes == NULL){
+        return NULL;
+    }
+    for(int i = 0; i < process_cnt; i++){
+        arrival += (long long)(xorshift64(&rng_state) % (unsigned long long)(2 * gap + 1));
+        processes[i].process_id = i + 1;
+        processes[i].arrival_timestamp = (int)MIN(arrival, 2147483647LL);
+        processes[i].total_bursttime = 1 + (int)(xorshift64(&rng_state) % (unsigned long long)burst);
+        processes[i].execution_starttime = 0;
+        processes[i].execution_endtime = 0;
+        processes[i].remaining_bursttime = processes[i].total_bursttime;
+        processes[i].process_priority = 1 + (int)(xorshift64(&rng_state) % (unsigned long long)priority_cnt);
+    }
+    return processes;
+}
+
+int main(int argc, char *argv[])
+{
+    const char *trace = NULL;
+    int process_cnt = 1000000;
+    int gap = 10;
+    int burst = 16;
+    int priority_cnt = 10;
+    int quantum = 4;
+    struct PCB *processes;
+
+    for(int i = 1; i < argc; i++){
+        if(strcmp(argv[i], "--trace") == 0 && i + 1 < argc){
+            trace = argv[++i];
+        }
+        else if(strcmp(argv[i], "--processes") == 0 && i + 1 < argc){
+            process_cnt = atoi(argv[++i]);
+        }
+        else if(strcmp(argv[i], "--gap") == 0 && i + 1 < argc){
+            gap = atoi(argv[++i]);
+        }
+        else if(strcmp(argv[i], "--burst") == 0 && i + 1 < argc){
+            burst = atoi(argv[++i]);
+        }
+        else if(strcmp(argv[i], "--priorities") == 0 && i + 1 < argc){
+            priority_cnt = atoi(argv[++i]);
+        }
+        else if(strcmp(argv[i], "--quantum") == 0 && i + 1 < argc){
+            quantum = atoi(argv[++i]);
+        }
+        else if(strcmp(argv[i], "--seed") == 0 && i + 1 < argc){
+            rng_state = strtoull(argv[++i], NULL, 10) | 1;
+        }
+        else {
+            fprintf(stderr, "usage: %s [--trace FILE] [--processes N] [--gap N] [--burst N] [--priorities N] [--quantum N] [--seed N]\n", argv[0]);
+            return 2;
+        }
+    }
+    if(process_cnt < 0 || gap < 0 || burst <= 0 || priority_cnt <= 0 || quantum <= 0){
+        fprintf(stderr, "%s: --burst, --priorities and --quantum must be positive and the other counts not negative\n", argv[0]);
+        return 2;
+    }
+    processes = trace != NULL ? read_trace(trace, &process_cnt) : make_trace(process_cnt, gap, burst, priority_cnt);
+    if(processes == NULL){
+        fprintf(stderr, "%s: cannot %s\n", argv[0], trace != NULL ? "read the trace" : "allocate the trace");
+        return 1;
+    }
+    qsort(processes, (size_t)process_cnt, sizeof(struct PCB), compare_arrivals);
+    printf("%-6s %9s %11s %12s %12s %12s %10s\n", "policy", "processes", "dispatches", "mean turn", "mean wait", "max wait",
+        "ns/proc");
+    for(int policy = 0; policy < POLICY_CNT; policy++){
+        struct CPU_STATS stats;
+
+        if(cpu_replay(policy, processes, process_cnt, quantum, &stats) != 0){
+            fprintf(stderr, "%s: %s replay failed\n", argv[0], policy_names[policy]);
+            free(processes);
+            return 1;
+        }
+        printf("%-6s %9lld %11lld %12.1f %12.1f %12lld %10.1f\n", policy_names[policy], stats.processes, stats.dispatches,
+            stats.processes > 0 ? (double)stats.total_turnaround / stats.processes : 0.0,
+            stats.processes > 0 ? (double)stats.total_waiting / stats.processes : 0.0, stats.max_waiting,
+            stats.processes > 0 ? (double)stats.elapsed_ns / stats.processes : 0.0);
+        fflush(stdout);
+    }
+    free(processes);
+    return 0;
+}
@@ -0,0 +1,288 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <limits.h>
+#include <math.h>
+#include "oslabs.h"
+
+/*Approximate miss-ratio curves by spatial hash sampling (SHARDS). A page is sampled when a hash of its
+page number, taken modulo SHARDS_MODULUS, falls below a threshold. Either every reference to a page is
+kept or none is, so the sample is a trace of a random rate-sized subset of the pages. Such a subset
+behaves like the whole trace seen through a cache scaled down by the same rate. Replaying the sample
+with frame_cnt * rate frames then gives a miss ratio that estimates the full trace's miss ratio with
+frame_cnt frames.
+
+The sample keeps the sampled references as dense page indices, renumbered in order of first
+appearance through an open-addressed hash. Memory and replay time are then about rate times those of
+the full trace. It also keeps the page number behind each index, and the replay's CLOCK list breaks
+second-chance ties by it rather than by the index, so at a rate of 1 the replay is the full trace's.
+
+Each sampled page stands for 1 / rate pages, so the estimate is the sampled faults divided by the
+rate. Dividing by the number of sampled references instead would let a single hot page, which is
+mostly hits, drag the estimate down when it happens to be sampled. Pages are the sampling units, so the
+estimate's variance comes from how unevenly the faults spread over the sampled pages. The error is the
+half-width of a normal 95% interval from that variance. It does not cover the bias of scaling the
+cache, which grows as frame_cnt * rate gets small.*/
+
+#define SHARDS_EMPTY (-1LL)
+
+static unsigned long long shards_hash(long long page_number)
+{
+    //splitmix64 finalizer, so neighbouring pages are sampled independently
+    unsigned long long x = (unsigned long long)page_number;
+
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    return x;
+}
+
+static int shards_home(int hash_bits, long long page_number)
+{
+    //Fibonacci hashing, independent of the sampling hash
+    return (int)(((unsigned long long)page_number * 11400714819323198485ULL) >> (64 - hash_bits));
+}
+
+static int shards_find(struct SHARDS_SAMPLE *s, long long page_number)
+{
+    //bucket holding the page, or the empty bucket where it would go
+    int mask = (1 << s->hash_bits) - 1;
+    int bucket = shards_home(s->hash_bits, page_number);
+
+    while(s->keys[bucket] != SHARDS_EMPTY && s->keys[bucket] != page_number){
+        bucket = (bucket + 1) & mask;
+    }
+    return bucket;
+}
+
+static int shards_rehash(struct SHARDS_SAMPLE *s, int hash_bits)
+{
+    //moves every page into a hash of 2^hash_bits buckets, with page_at grown to match
+    long long *keys = malloc(((size_t)1 << hash_bits) * sizeof(long long));
+    int *slots = malloc(((size_t)1 << hash_bits) * sizeof(int));
+    long long *old_keys = s->keys;
+    int *old_slots = s->slots;
+    int old_bits = s->hash_bits;
+    long long *page_at;
+
+    if(keys == NULL || slots == NULL){
+        free(keys);
+        free(slots);
+        return -1;
+    }
+    page_at = realloc(s->page_at, ((size_t)1 << hash_bits) * sizeof(long long)); //the hash is never more than half full
+    if(page_at == NULL){
+        free(keys);
+        free(slots);
+        return -1;
+    }
+    s->page_at = page_at;
+    for(int i = 0; i < 1 << hash_bits; i++){
+        keys[i] = SHARDS_EMPTY;
+    }
+    s->keys = keys;
+    s->slots = slots;
+    s->hash_bits = hash_bits;
+    for(int i = 0; old_keys != NULL && i < 1 << old_bits; i++){
+        if(old_keys[i] != SHARDS_EMPTY){
+            int bucket = shards_find(s, old_keys[i]);
+
+            keys[bucket] = old_keys[i];
+            slots[bucket] = old_slots[i];
+        }
+    }
+    free(old_keys);
+    free(old_slots);
+    return 0;
+}
+
+struct SHARDS_SAMPLE *shards_create(double rate)
+{
+    /*Creates an empty sample of about rate of the page space, 0 < rate <= 1. The rate is rounded to a
+whole number of the SHARDS_MODULUS hash values, and the rate actually used is in the sample's rate.
+Returns NULL if rate is out of range or memory cannot be allocated.*/
+    struct SHARDS_SAMPLE *s;
+
+    if(!(rate > 0.0 && rate <= 1.0)){
+        return NULL;
+    }
+    s = malloc(sizeof(struct SHARDS_SAMPLE));
+    if(s == NULL){
+        return NULL;
+    }
+    s->threshold = MAX(1LL, (long long)(rate * SHARDS_MODULUS + 0.5));
+    s->rate = (double)s->threshold / SHARDS_MODULUS;
+    s->references = 0;
+    s->reference_cnt = 0;
+    s->reference_cap = 4096;
+    s->table_cnt = 0;
+    s->hash_bits = 0;
+    s->keys = NULL;
+    s->slots = NULL;
+    s->page_at = NULL;
+    s->reference_string = malloc((size_t)s->reference_cap * sizeof(int));
+    if(s->reference_string == NULL || shards_rehash(s, 11) != 0){
+        shards_destroy(s);
+        return NULL;
+    }
+    return s;
+}
+
+void shards_destroy(struct SHARDS_SAMPLE *s)
+{
+    if(s != NULL){
+        free(s->reference_string);
+        free(s->keys);
+        free(s->slots);
+        free(s->page_at);
+        free(s);
+    }
+}
+
+int shards_add(struct SHARDS_SAMPLE *s, long long page_number)
+{
+    /*Offers one reference to the sample. Returns 1 if its page is sampled and the reference kept, 0 if
+not, and -1 if the sample cannot grow, which leaves it as it was.*/
+    int bucket;
+
+    if((long long)(shards_hash(page_number) & (SHARDS_MODULUS - 1)) >= s->threshold){
+        s->references += 1;
+        return 0;
+    }
+    if(s->reference_cnt == s->reference_cap){
+        int *grown;
+
+        if(s->reference_cap > 1073741823){
+            return -1;
+        }
+        grown = realloc(s->reference_string, (size_t)s->reference_cap * 2 * sizeof(int));
+        if(grown == NULL){
+            return -1;
+        }
+        s->reference_string = grown;
+        s->reference_cap *= 2;
+    }
+    bucket = shards_find(s, page_number);
+    if(s->keys[bucket] == SHARDS_EMPTY){
+        if(2 * (s->table_cnt + 1) > 1 << s->hash_bits){
+            if(shards_rehash(s, s->hash_bits + 1) != 0){
+                return -1; //at most half full
+            }
+            bucket = shards_find(s, page_number);
+        }
+        s->keys[bucket] = page_number;
+        s->page_at[s->table_cnt] = page_number;
+        s->slots[bucket] = s->table_cnt++;
+    }
+    s->reference_string[s->reference_cnt++] = s->slots[bucket];
+    s->references += 1;
+    return 1;
+}
+
+long long shards_add_trace(struct SHARDS_SAMPLE *s, struct TRACE_READER *trace)
+{
+    /*Offers every reference of a trace in any of the TRACE_ formats. Returns the number of references
+read, or -1 if the trace cannot be read or the sample cannot grow.*/
+    long long references = s->references;
+    long long page_number;
+    int got;
+
+    while((got = trace_next(trace, &page_number)) == 1){
+        if(shards_add(s, page_number) == -1){
+            return -1;
+        }
+    }
+    if(got == -1){
+        return -1;
+    }
+    return s->references - references;
+}
+
+static int shards_replay(struct SHARDS_SAMPLE *s,
+struct PAGE_CONTEXT *ctx,
+int policy,
+int frame_cnt,
+int page_faults[],
+struct SHARDS_ESTIMATE *estimate)
+{
+    /*Replays the sample in ctx at the scaled frame count and fills in the estimate, using page_faults
+to count each sampled page's faults.*/
+    double sum_faults2 = 0.0;
+
+    estimate->policy = policy;
+    estimate->frame_cnt = frame_cnt;
+    estimate->sampled_frames = (int)(frame_cnt * s->rate + 0.5); //at least 1, shards_curve checked
+    estimate->sampled_references = s->reference_cnt;
+    estimate->sampled_faults = 0;
+    estimate->miss_ratio = 0.0;
+    estimate->page_faults = 0.0;
+    estimate->error = 0.0;
+    if(page_context_reset(ctx, policy, estimate->sampled_frames) != 0){
+        return -1;
+    }
+    ctx->list.rank = s->page_at; //CLOCK ties go by the real page number, reseeding the list cleared it
+    for(int i = 0; i < s->table_cnt; i++){
+        page_faults[i] = 0;
+    }
+    for(int i = 0; i < s->reference_cnt; i++){
+        long long before = ctx->page_faults;
+        int page = s->reference_string[i];
+
+        if(ctx->timestamp == INT_MAX || page_context_access(ctx, page, ctx->timestamp) == -1){
+            return -1;
+        }
+        ctx->timestamp += 1;
+        page_faults[page] += (int)(ctx->page_faults - before);
+    }
+    estimate->sampled_faults = ctx->page_faults;
+    for(int i = 0; i < s->table_cnt; i++){
+        sum_faults2 += (double)page_faults[i] * page_faults[i];
+    }
+    estimate->page_faults = ctx->page_faults / s->rate;
+    estimate->miss_ratio = s->references > 0 ? MIN(1.0, estimate->page_faults / s->references) : 0.0;
+    estimate->error = 1.96 * sqrt((1.0 - s->rate) * sum_faults2) / s->rate; //pages sampled independently at the rate
+    return 0;
+}
+
+int shards_curve(struct SHARDS_SAMPLE *s,
+int policy,
+int frame_cnts[],
+int curve_cnt,
+struct SHARDS_ESTIMATE estimates[])
+{
+    /*Estimates the faults the whole trace so far causes under policy for each of the frame counts,
+starting from an empty page table, and stores them in estimates in the same order. Every policy
+page_context_create accepts can be used. Returns -1 if a frame count scales to less than one sampled
+frame, frame_cnt * rate < 1, which includes a frame count of 0, or if memory cannot be allocated.*/
+    struct PAGE_CONTEXT *ctx;
+    int *page_faults;
+    int pool_cnt = 1;
+    int status = 0;
+
+    for(int i = 0; i < curve_cnt; i++){
+        if(frame_cnts[i] <= 0 || frame_cnts[i] * s->rate < 1.0){
+            return -1; //nothing to replay it with, rounding up would estimate a larger memory
+        }
+        pool_cnt = MAX(pool_cnt, (int)(frame_cnts[i] * s->rate + 0.5));
+    }
+    ctx = page_context_create(MAX(1, s->table_cnt), pool_cnt, policy);
+    page_faults = malloc((size_t)MAX(1, s->table_cnt) * sizeof(int));
+    if(ctx == NULL || page_faults == NULL){
+        page_context_destroy(ctx);
+        free(page_faults);
+        return -1;
+    }
+    for(int i = 0; i < curve_cnt && status == 0; i++){
+        status = shards_replay(s, ctx, policy, frame_cnts[i], page_faults, &estimates[i]);
+    }
+    page_context_destroy(ctx);
+    free(page_faults);
+    return status;
+}
+
+int shards_estimate(struct SHARDS_SAMPLE *s, int policy, int frame_cnt, struct SHARDS_ESTIMATE *estimate)
+{
+    //shards_curve for a single frame count
+    return shards_curve(s, policy, &frame_cnt, 1, estimate);
+}
@@ -0,0 +1,199 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <limits.h>
+#include "oslabs.h"
+
+/*A SPARSE_TABLE takes page numbers anywhere in a 63-bit address space and keeps entries only for the
+pages in memory, so it needs memory for the frame pool rather than for the largest page number.
+
+Each page in memory gets a slot in a small dense page table that a PAGE_CONTEXT runs the replacement
+policy over, and an open-addressed hash with linear probing maps page numbers to slots. FIFO, LRU, LFU
+and CLOCK forget everything about a page once it leaves memory, so its slot and hash entry are given
+back on eviction. The dense table then never needs more than pool_cnt + 1 slots: one per frame and one
+for the page coming in before the victim leaves. The hash is sized for that once and never grows.
+
+Slots are handed out in no particular order, but CLOCK breaks ties between pages that got their second
+chance together by page number. The context's CLOCK list ranks the slots by the page each one holds,
+so the table replaces exactly the pages a flat table of the same page numbers would.
+
+CLOCK-Pro, ARC and 2Q still remember pages after evicting them, which would keep their slots alive, so
+they are not offered here.*/
+
+#define SPARSE_EMPTY (-1LL)
+
+static int sparse_home(struct SPARSE_TABLE *st, long long page_number)
+{
+    //Fibonacci hashing, the top bits of the product pick the bucket
+    return (int)(((unsigned long long)page_number * 11400714819323198485ULL) >> (64 - st->hash_bits));
+}
+
+static int sparse_find(struct SPARSE_TABLE *st, long long page_number)
+{
+    //bucket holding the page, or the empty bucket where it would go
+    int mask = (1 << st->hash_bits) - 1;
+    int bucket = sparse_home(st, page_number);
+
+    while(st->keys[bucket] != SPARSE_EMPTY && st->keys[bucket] != page_number){
+        bucket = (bucket + 1) & mask;
+    }
+    return bucket;
+}
+
+static void sparse_erase(struct SPARSE_TABLE *st, int bucket)
+{
+    /*Empties the bucket and moves later entries of the same probe run back into the gap, so lookups
+never need tombstones.*/
+    int mask = (1 << st->hash_bits) - 1;
+    int next = (bucket + 1) & mask;
+
+    while(st->keys[next] != SPARSE_EMPTY){
+        int home = sparse_home(st, st->keys[next]);
+
+        if(((next - home) & mask) >= ((next - bucket) & mask)){
+            st->keys[bucket] = st->keys[next]; //home is at or before the gap, so the entry can move into it
+            st->slots[bucket] = st->slots[next];
+            bucket = next;
+        }
+        next = (next + 1) & mask;
+    }
+    st->keys[bucket] = SPARSE_EMPTY;
+}
+
+static void sparse_clear(struct SPARSE_TABLE *st)
+{
+    for(int i = 0; i < 1 << st->hash_bits; i++){
+        st->keys[i] = SPARSE_EMPTY;
+    }
+    for(int i = 0; i < st->slot_cnt; i++){
+        st->page_at[i] = SPARSE_EMPTY;
+        st->free_slots[i] = st->slot_cnt - 1 - i; //slot 0 is handed out first
+    }
+    st->free_cnt = st->slot_cnt;
+}
+
+struct SPARSE_TABLE *sparse_table_create(int pool_cnt, int policy)
+{
+    /*Creates an empty sparse page table over a frame pool of frames 0 to pool_cnt - 1, replacing pages
+by policy, which is POLICY_FIFO, POLICY_LRU, POLICY_LFU or POLICY_CLOCK. Returns NULL if an argument
+is invalid or memory cannot be allocated.*/
+    struct ARENA arena;
+    struct SPARSE_TABLE *st;
+    int hash_bits = 1;
+    int slot_cnt;
+
+    if(pool_cnt < 0 || pool_cnt > (1 << 28)
+        || (policy != POLICY_FIFO && policy != POLICY_LRU && policy != POLICY_LFU && policy != POLICY_CLOCK)){
+        return NULL;
+    }
+    slot_cnt = pool_cnt + 1;
+    while((1 << hash_bits) < 2 * slot_cnt){
+        hash_bits += 1; //at most half full
+    }
+    arena.base = malloc(arena_size(sizeof(struct SPARSE_TABLE))
+        + arena_size(((size_t)1 << hash_bits) * sizeof(long long)) + arena_size(((size_t)1 << hash_bits) * sizeof(int))
+        + arena_size((size_t)slot_cnt * sizeof(long long)) + arena_size((size_t)slot_cnt * sizeof(int)));
+    arena.used = 0;
+    if(arena.base == NULL){
+        return NULL;
+    }
+    st = arena_take(&arena, sizeof(struct SPARSE_TABLE));
+    st->arena = arena.base;
+    st->hash_bits = hash_bits;
+    st->slot_cnt = slot_cnt;
+    st->keys = arena_take(&arena, ((size_t)1 << hash_bits) * sizeof(long long));
+    st->slots = arena_take(&arena, ((size_t)1 << hash_bits) * sizeof(int));
+    st->page_at = arena_take(&arena, (size_t)slot_cnt * sizeof(long long));
+    st->free_slots = arena_take(&arena, (size_t)slot_cnt * sizeof(int));
+    st->ctx = page_context_create(slot_cnt, pool_cnt, policy);
+    if(st->ctx == NULL){
+        free(arena.base);
+        return NULL;
+    }
+    st->ctx->list.rank = st->page_at; //CLOCK ties go by the real page number
+    sparse_clear(st);
+    return st;
+}
+
+void sparse_table_destroy(struct SPARSE_TABLE *st)
+{
+    if(st != NULL){
+        page_context_destroy(st->ctx);
+        free(st->arena); //the table itself lives in the arena
+    }
+}
+
+void sparse_table_reset(struct SPARSE_TABLE *st)
+{
+    //every page out of memory, the pool full again and the counters and timestamp started over
+    page_context_reset(st->ctx, st->ctx->policy, st->ctx->pool_cnt);
+    st->ctx->list.rank = st->page_at; //reseeding the list cleared it
+    sparse_clear(st);
+}
+
+struct PTE *sparse_table_lookup(struct SPARSE_TABLE *st, long long page_number)
+{
+    //the page's entry if it is in memory, NULL otherwise
+    int bucket;
+
+    if(page_number < 0){
+        return NULL;
+    }
+    bucket = sparse_find(st, page_number);
+    if(st->keys[bucket] == SPARSE_EMPTY){
+        return NULL;
+    }
+    return &st->ctx->page_table[st->slots[bucket]];
+}
+
+int sparse_table_access(struct SPARSE_TABLE *st, long long page_number, int current_timestamp)
+{
+    /*Returns the frame number of the page, loading it if needed, with the same page-table updates and
+counters as page_context_access on a flat table. Returns -1 if page_number is negative or there is
+neither a free frame nor a page to replace.*/
+    struct PAGE_CONTEXT *ctx = st->ctx;
+    int bucket;
+    int slot;
+    int evicted;
+    int frame_number;
+
+    if(page_number < 0){
+        return -1;
+    }
+    bucket = sparse_find(st, page_number);
+    if(st->keys[bucket] != SPARSE_EMPTY){
+        return page_context_access(ctx, st->slots[bucket], current_timestamp);
+    }
+    slot = st->free_slots[--st->free_cnt]; //there is always one, since at most pool_cnt pages are in memory
+    st->keys[bucket] = page_number;
+    st->slots[bucket] = slot;
+    st->page_at[slot] = page_number;
+    frame_number = page_context_access(ctx, slot, current_timestamp);
+    evicted = frame_number == -1 ? slot : ctx->evicted_page; //on failure the page never came in
+    if(evicted != -1){
+        sparse_erase(st, sparse_find(st, st->page_at[evicted]));
+        st->page_at[evicted] = SPARSE_EMPTY;
+        st->free_slots[st->free_cnt++] = evicted; //the engine already cleared its entry
+    }
+    return frame_number;
+}
+
+long long sparse_table_run_trace(struct SPARSE_TABLE *st, struct TRACE_READER *trace)
+{
+    /*Processes a trace of page numbers in any of the TRACE_ formats, giving each access the context's
+next timestamp. Returns the number of page faults in this run, or -1 if the trace cannot be read, an
+access fails or the timestamp reaches INT_MAX, as count_page_faults_trace does.*/
+    long long page_faults = st->ctx->page_faults;
+    long long page_number;
+    int got;
+
+    while((got = trace_next(trace, &page_number)) == 1){
+        if(st->ctx->timestamp == INT_MAX || sparse_table_access(st, page_number, st->ctx->timestamp) == -1){
+            return -1;
+        }
+        st->ctx->timestamp += 1;
+    }
+    if(got == -1){
+        return -1;
+    }
+    return st->ctx->page_faults - page_faults;
+}
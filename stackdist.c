@@ -0,0 +1,192 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "oslabs.h"
+
+/*LRU is a stack algorithm: with f frames, a reference hits exactly when fewer than f other pages were
+referenced since the last reference to the same page. That count plus one is the reference's stack
+distance. One pass that records a histogram of stack distances therefore gives the LRU fault count for
+every frame count at once, the Mattson stack-distance method.
+
+Each page's latest reference is marked at its position in a Fenwick tree over reference positions. The
+distance of a new reference is the number of marks after the page's previous position, which is one
+prefix sum, so a reference costs O(log n). When the positions run out, the marks (one per page) are
+packed to the front. That keeps the tree at a fixed size however long the reference string is.*/
+
+static void tree_add(struct STACK_DISTANCE *sd, int position, int delta)
+{
+    for(; position <= sd->capacity; position += position & -position){
+        sd->tree[position] += delta;
+    }
+}
+
+static int tree_sum(struct STACK_DISTANCE *sd, int position)
+{
+    //number of marks at positions 1 to position
+    int sum = 0;
+
+    for(; position > 0; position -= position & -position){
+        sum += sd->tree[position];
+    }
+    return sum;
+}
+
+static void stack_distance_compact(struct STACK_DISTANCE *sd)
+{
+    /*Moves every page's latest reference to positions 1 to distinct, keeping their order, and rebuilds
+the tree in linear time.*/
+    int packed = 0;
+
+    for(int position = 1; position <= sd->position; position++){
+        int page = sd->page_at[position];
+        if(page != -1 && sd->last_position[page] == position){
+            packed++;
+            sd->page_at[packed] = page;
+            sd->last_position[page] = packed;
+        }
+    }
+    for(int position = 1; position <= sd->capacity; position++){
+        sd->tree[position] = position <= packed ? 1 : 0;
+        if(position > packed){
+            sd->page_at[position] = -1;
+        }
+    }
+    for(int position = 1; position <= sd->capacity; position++){
+        int parent = position + (position & -position);
+        if(parent <= sd->capacity){
+            sd->tree[parent] += sd->tree[position];
+        }
+    }
+    sd->position = packed;
+}
+
+struct STACK_DISTANCE *stack_distance_create(int table_cnt)
+{
+    /*Creates an analyzer for pages 0 to table_cnt - 1 with no references yet. Returns NULL if table_cnt
+is not positive or the arena cannot be allocated.*/
+    struct ARENA arena;
+    struct STACK_DISTANCE *sd;
+    int capacity;
+
+    if(table_cnt <= 0){
+        return NULL;
+    }
+    capacity = table_cnt < 1024 ? 2048 : 2 * table_cnt; //at least half the positions are free after a compaction
+    arena.base = malloc(arena_size(sizeof(struct STACK_DISTANCE))
+        + arena_size((size_t)table_cnt * sizeof(int))
+        + 2 * arena_size(((size_t)capacity + 1) * sizeof(int))
+        + arena_size(((size_t)table_cnt + 1) * sizeof(long long)));
+    arena.used = 0;
+    if(arena.base == NULL){
+        return NULL;
+    }
+    sd = arena_take(&arena, sizeof(struct STACK_DISTANCE));
+    sd->arena = arena.base;
+    sd->table_cnt = table_cnt;
+    sd->capacity = capacity;
+    sd->position = 0;
+    sd->distinct = 0;
+    sd->cold_misses = 0;
+    sd->references = 0;
+    sd->last_position = arena_take(&arena, (size_t)table_cnt * sizeof(int));
+    sd->page_at = arena_take(&arena, ((size_t)capacity + 1) * sizeof(int));
+    sd->tree = arena_take(&arena, ((size_t)capacity + 1) * sizeof(int));
+    sd->histogram = arena_take(&arena, ((size_t)table_cnt + 1) * sizeof(long long));
+    for(int i = 0; i < table_cnt; i++){
+        sd->last_position[i] = 0;
+    }
+    for(int i = 0; i <= capacity; i++){
+        sd->page_at[i] = -1;
+        sd->tree[i] = 0;
+    }
+    for(int i = 0; i <= table_cnt; i++){
+        sd->histogram[i] = 0;
+    }
+    return sd;
+}
+
+void stack_distance_destroy(struct STACK_DISTANCE *sd)
+{
+    if(sd != NULL){
+        free(sd->arena);
+    }
+}
+
+int stack_distance_access(struct STACK_DISTANCE *sd, int page_number)
+{
+    /*Records one reference and returns its stack distance, 0 for the first reference to a page (a
+miss for every frame count). Returns -1 if page_number is outside the table.*/
+    int last;
+    int distance = 0;
+
+    if(page_number < 0 || page_number >= sd->table_cnt){
+        return -1;
+    }
+    if(sd->position == sd->capacity){
+        stack_distance_compact(sd);
+    }
+    last = sd->last_position[page_number];
+    if(last == 0){
+        sd->cold_misses += 1;
+        sd->distinct += 1;
+    }
+    else {
+        distance = sd->distinct - tree_sum(sd, last) + 1; //pages referenced after it, plus itself
+        sd->histogram[distance] += 1;
+        tree_add(sd, last, -1);
+    }
+    sd->position += 1;
+    sd->last_position[page_number] = sd->position;
+    sd->page_at[sd->position] = page_number;
+    tree_add(sd, sd->position, 1);
+    sd->references += 1;
+    return distance;
+}
+
+int stack_distance_curve(struct STACK_DISTANCE *sd, long long page_faults[], int max_frames)
+{
+    /*Fills page_faults[f - 1] with the number of LRU page faults the references so far cause with f
+frames, for f from 1 to max_frames, starting from an empty page table. A reference at distance d
+faults whenever d > f. Returns -1 if max_frames is not positive.*/
+    long long misses = sd->cold_misses;
+
+    if(max_frames <= 0){
+        return -1;
+    }
+    for(int d = sd->table_cnt; d > max_frames; d--){
+        misses += sd->histogram[d];
+    }
+    for(int f = max_frames; f >= 1; f--){
+        page_faults[f - 1] = misses;
+        if(f <= sd->table_cnt){
+            misses += sd->histogram[f]; //distance f misses with f - 1 frames
+        }
+    }
+    return 0;
+}
+
+int count_page_faults_lru_curve(int reference_string[],
+int reference_cnt,
+int table_cnt,
+long long page_faults[],
+int max_frames)
+{
+    /*The miss-ratio curve of a reference string in one pass: page_faults[f - 1] receives what
+count_page_faults_lru would return for an empty page table and a pool of f frames. Returns -1 if the
+analyzer cannot be allocated or the reference string names a page outside the table.*/
+    struct STACK_DISTANCE *sd = stack_distance_create(table_cnt);
+    int status = 0;
+
+    if(sd == NULL){
+        return -1;
+    }
+    for(int i = 0; i < reference_cnt && status == 0; i++){
+        if(stack_distance_access(sd, reference_string[i]) == -1){
+            status = -1;
+        }
+    }
+    if(status == 0){
+        status = stack_distance_curve(sd, page_faults, max_frames);
+    }
+    stack_distance_destroy(sd);
+    return status;
+}
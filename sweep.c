@@ -0,0 +1,227 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <pthread.h>
+#include "oslabs.h"
+
+/*sweep_run fills in one result per (policy, frame count, trace) job, running the jobs on a pool of
+threads. Every worker has its own PAGE_CONTEXT, so no page table is shared and the jobs need no locking
+beyond handing them out. The jobs start out split into one contiguous range per worker. A worker takes
+jobs from the back of its own range and, once that is empty, steals from the front of the others'
+ranges. Jobs with long traces or large tables then do not leave the other workers idle.*/
+
+struct SWEEP_DEQUE {
+    pthread_mutex_t lock;
+    int top; //next job a thief takes
+    int bottom; //one past the next job the owner takes
+};
+
+struct SWEEP_WORKER {
+    pthread_t thread;
+    int id;
+    struct SWEEP_SHARED *shared;
+};
+
+struct SWEEP_SHARED {
+    struct SWEEP_TRACE *traces;
+    int trace_cnt;
+    struct SWEEP_JOB *jobs;
+    struct SWEEP_RESULT *results;
+    struct SWEEP_DEQUE *deques;
+    int worker_cnt;
+    int table_cnt; //largest table of any trace
+    int pool_cnt; //largest frame count of any job
+};
+
+static const char *policy_name(int policy)
+{
+    switch(policy){
+    case POLICY_FIFO:
+        return "FIFO";
+    case POLICY_LRU:
+        return "LRU";
+    case POLICY_LFU:
+        return "LFU";
+    case POLICY_CLOCK:
+        return "CLOCK";
+    case POLICY_CLOCK_PRO:
+        return "CLKPRO";
+    case POLICY_ARC:
+        return "ARC";
+    case POLICY_2Q:
+        return "2Q";
+    }
+    return "?";
+}
+
+static int deque_pop(struct SWEEP_DEQUE *deque)
+{
+    int job = -1;
+
+    pthread_mutex_lock(&deque->lock);
+    if(deque->top < deque->bottom){
+        deque->bottom -= 1;
+        job = deque->bottom;
+    }
+    pthread_mutex_unlock(&deque->lock);
+    return job;
+}
+
+static int deque_steal(struct SWEEP_DEQUE *deque)
+{
+    int job = -1;
+
+    pthread_mutex_lock(&deque->lock);
+    if(deque->top < deque->bottom){
+        job = deque->top;
+        deque->top += 1;
+    }
+    pthread_mutex_unlock(&deque->lock);
+    return job;
+}
+
+static int next_job(struct SWEEP_SHARED *shared, int id)
+{
+    //own work first, then one job from each other worker in turn until all ranges are empty
+    int job = deque_pop(&shared->deques[id]);
+
+    for(int i = 1; job == -1 && i < shared->worker_cnt; i++){
+        job = deque_steal(&shared->deques[(id + i) % shared->worker_cnt]);
+    }
+    return job;
+}
+
+static void run_job(struct SWEEP_SHARED *shared, struct PAGE_CONTEXT *ctx, int job)
+{
+    struct SWEEP_JOB *spec = &shared->jobs[job];
+    struct SWEEP_RESULT *result = &shared->results[job];
+    struct SWEEP_TRACE *trace;
+    long long start;
+
+    result->policy = spec->policy;
+    result->frame_cnt = spec->frame_cnt;
+    result->trace = spec->trace;
+    result->status = -1;
+    result->page_faults = 0;
+    result->page_hits = 0;
+    result->evictions = 0;
+    result->ghost_hits = 0;
+    result->elapsed_ns = 0;
+    if(ctx == NULL || spec->trace < 0 || spec->trace >= shared->trace_cnt
+        || page_context_reset(ctx, spec->policy, spec->frame_cnt) != 0){
+        return;
+    }
+    trace = &shared->traces[spec->trace];
+    start = monotonic_ns();
+    if(page_context_run(ctx, trace->reference_string, trace->reference_cnt) == -1){
+        return;
+    }
+    result->elapsed_ns = monotonic_ns() - start;
+    result->page_faults = ctx->page_faults;
+    result->page_hits = ctx->page_hits;
+    result->evictions = ctx->evictions;
+    result->ghost_hits = ctx->ghost_hits;
+    result->status = 0;
+}
+
+static void *sweep_worker(void *arg)
+{
+    struct SWEEP_WORKER *worker = arg;
+    struct SWEEP_SHARED *shared = worker->shared;
+    struct PAGE_CONTEXT *ctx = page_context_create(shared->table_cnt, shared->pool_cnt, POLICY_FIFO);
+    int job;
+
+    while((job = next_job(shared, worker->id)) != -1){
+        run_job(shared, ctx, job); //a NULL context marks its jobs as failed
+    }
+    page_context_destroy(ctx);
+    return NULL;
+}
+
+int sweep_run(struct SWEEP_TRACE traces[],
+int trace_cnt,
+struct SWEEP_JOB jobs[],
+int job_cnt,
+struct SWEEP_RESULT results[],
+int thread_cnt)
+{
+    /*Runs every job and stores its result at the same index of results. thread_cnt of 0 or less uses
+one thread per online processor. Returns 0 when every job ran and -1 when any job failed (its status
+is -1) or the threads could not be started.*/
+    struct SWEEP_SHARED shared;
+    struct SWEEP_WORKER *workers;
+    int started = 0;
+    int status = 0;
+
+    if(thread_cnt <= 0){
+        long online = sysconf(_SC_NPROCESSORS_ONLN);
+        thread_cnt = online > 0 ? (int)online : 1;
+    }
+    if(thread_cnt > job_cnt){
+        thread_cnt = job_cnt > 0 ? job_cnt : 1;
+    }
+    shared.traces = traces;
+    shared.trace_cnt = trace_cnt;
+    shared.jobs = jobs;
+    shared.results = results;
+    shared.worker_cnt = thread_cnt;
+    shared.table_cnt = 1;
+    shared.pool_cnt = 0;
+    for(int i = 0; i < trace_cnt; i++){
+        shared.table_cnt = MAX(shared.table_cnt, traces[i].table_cnt);
+    }
+    for(int i = 0; i < job_cnt; i++){
+        shared.pool_cnt = MAX(shared.pool_cnt, jobs[i].frame_cnt);
+    }
+    workers = malloc((size_t)thread_cnt * (sizeof(struct SWEEP_WORKER) + sizeof(struct SWEEP_DEQUE)));
+    if(workers == NULL){
+        return -1;
+    }
+    shared.deques = (struct SWEEP_DEQUE *)(workers + thread_cnt);
+    for(int i = 0; i < thread_cnt; i++){
+        pthread_mutex_init(&shared.deques[i].lock, NULL);
+        shared.deques[i].top = (int)((long long)job_cnt * i / thread_cnt);
+        shared.deques[i].bottom = (int)((long long)job_cnt * (i + 1) / thread_cnt);
+        workers[i].id = i;
+        workers[i].shared = &shared;
+    }
+    for(int i = 1; i < thread_cnt; i++){
+        if(pthread_create(&workers[i].thread, NULL, sweep_worker, &workers[i]) != 0){
+            break; //the threads that did start steal the missing worker's jobs
+        }
+        started = i;
+    }
+    sweep_worker(&workers[0]); //the calling thread is worker 0
+    for(int i = 1; i <= started; i++){
+        pthread_join(workers[i].thread, NULL);
+    }
+    for(int i = 0; i < thread_cnt; i++){
+        pthread_mutex_destroy(&shared.deques[i].lock);
+    }
+    free(workers);
+    for(int i = 0; i < job_cnt; i++){
+        if(results[i].status != 0){
+            status = -1;
+        }
+    }
+    return status;
+}
+
+void sweep_print(FILE *out, struct SWEEP_RESULT results[], int job_cnt)
+{
+    //one row per job, in job order
+    fprintf(out, "%-6s %8s %6s %14s %14s %14s %14s %12s\n", "policy", "frames", "trace", "faults", "hits", "evictions", "ghost hits",
+        "ns/ref");
+    for(int i = 0; i < job_cnt; i++){
+        struct SWEEP_RESULT *result = &results[i];
+        long long references = result->page_faults + result->page_hits;
+
+        if(result->status != 0){
+            fprintf(out, "%-6s %8d %6d %14s\n", policy_name(result->policy), result->frame_cnt, result->trace, "failed");
+            continue;
+        }
+        fprintf(out, "%-6s %8d %6d %14lld %14lld %14lld %14lld %12.2f\n", policy_name(result->policy), result->frame_cnt,
+            result->trace, result->page_faults, result->page_hits, result->evictions, result->ghost_hits,
+            references > 0 ? (double)result->elapsed_ns / (double)references : 0.0);
+    }
+}
@@ -0,0 +1,1347 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <unistd.h>
+#include "oslabs.h"
+
+/*Checks each part of the library against a simpler way of computing the same thing, or against counts
+worked out by hand. The page replacement checks compare the ways of computing the same page faults:
+count_page_faults_* replays a string through a context's replacement engine, process_page_access_*
+finds each victim by scanning the page table, and count_page_faults_lru_curve gets every LRU frame
+count from one pass of stack distances. Each check is named for what it covers and can be run on its
+own, which is how ctest runs them:
+
+    oslabs_test [--check NAME] [--seed N] [--rounds N]
+
+Random checks draw from one xorshift64 generator, so a seed repeats a run. Prints each mismatch and
+exits with 1 if there was any.*/
+
+#define TEST_TABLE_MAX 64
+#define TEST_REFS_MAX 2000
+#define TEST_MAP_MAX 256
+#define TEST_QUEUE_MAX 64
+
+struct TEST_CHECK {
+        const char *name;
+        void (*run)(int rounds); //rounds of random input, ignored by the fixed checks
+    };
+
+struct TEST_POLICY {
+        const char *name;
+        int policy; //the POLICY_ value count and process stand for
+        int (*count)(struct PTE page_table[], int table_cnt, int reference_string[], int reference_cnt, int frame_pool[], int frame_cnt);
+        int (*process)(struct PTE page_table[], int *table_cnt, int page_number, int frame_pool[], int *frame_cnt, int current_timestamp);
+    };
+
+static const struct TEST_POLICY policies[] = {
+    { "fifo", POLICY_FIFO, count_page_faults_fifo, process_page_access_fifo },
+    { "lru", POLICY_LRU, count_page_faults_lru, process_page_access_lru },
+    { "lfu", POLICY_LFU, count_page_faults_lfu, process_page_access_lfu },
+    { "clock", POLICY_CLOCK, count_page_faults_clock, process_page_access_clock },
+};
+
+static int (*const policy_counts[])(struct PTE page_table[], int table_cnt, int reference_string[], int reference_cnt, int frame_pool[],
+    int frame_cnt) = { count_page_faults_fifo, count_page_faults_lru, count_page_faults_lfu, count_page_faults_clock,
+    count_page_faults_clockpro, count_page_faults_arc, count_page_faults_2q }; //indexed by POLICY_ value
+
+static unsigned long long rng_state = XORSHIFT64_SEED;
+static int failures;
+
+static void clear_table(struct PTE page_table[], int table_cnt, int frame_pool[], int frame_cnt)
+{
+    for(int i = 0; i < table_cnt; i++){
+        page_table[i].is_valid = 0;
+        page_table[i].frame_number = -1;
+        page_table[i].arrival_timestamp = -1;
+        page_table[i].last_access_timestamp = -1;
+        page_table[i].reference_count = -1;
+        page_table[i].reference_bit = 0;
+    }
+    for(int i = 0; i < frame_cnt; i++){
+        frame_pool[i] = i;
+    }
+}
+
+static int scan_faults(const struct TEST_POLICY *policy,
+struct PTE page_table[],
+int table_cnt,
+int reference_string[],
+int reference_cnt,
+int frame_pool[],
+int frame_cnt)
+{
+    //the same run as policy->count, one process_page_access_* call per reference
+    int page_fault_counter = 0;
+
+    for(int i = 0; i < reference_cnt; i++){
+        page_fault_counter += page_table[reference_string[i]].is_valid == 0;
+        if(policy->process(page_table, &table_cnt, reference_string[i], frame_pool, &frame_cnt, i + 1) == -1){
+            return -1;
+        }
+    }
+    return page_fault_counter;
+}
+
+static void fail(const char *what, const char *name, int round, long long expected, long long got)
+{
+    fprintf(stderr, "%s %s, round %d: expected %lld, got %lld\n", what, name, round, expected, got);
+    failures += 1;
+}
+
+static int random_string(int reference_string[], int table_cnt)
+{
+    //fills in a random string of up to TEST_REFS_MAX - 1 pages, half the time skewed toward low pages
+    int reference_cnt = (int)(xorshift64(&rng_state) % TEST_REFS_MAX);
+    int hot = 1 + (int)(xorshift64(&rng_state) % (unsigned long long)table_cnt);
+
+    for(int i = 0; i < reference_cnt; i++){
+        reference_string[i] = (int)(xorshift64(&rng_state) % (unsigned long long)(xorshift64(&rng_state) % 2 ? hot : table_cnt));
+    }
+    return reference_cnt;
+}
+
+static void check_engines(int rounds)
+{
+    /*Engine against scan on random strings, faults and the final page tables. The LRU and LFU engines
+(lru_list_access, lfu_table_access) and the CLOCK list must pick every victim the scan picks.*/
+    static struct PTE engine_table[TEST_TABLE_MAX];
+    static struct PTE scan_table[TEST_TABLE_MAX];
+    static int engine_pool[TEST_TABLE_MAX];
+    static int scan_pool[TEST_TABLE_MAX];
+    static int reference_string[TEST_REFS_MAX];
+
+    for(int round = 0; round < rounds; round++){
+        int table_cnt = 1 + (int)(xorshift64(&rng_state) % TEST_TABLE_MAX);
+        int frame_cnt = 1 + (int)(xorshift64(&rng_state) % (unsigned long long)table_cnt);
+        int reference_cnt = random_string(reference_string, table_cnt);
+
+        for(size_t p = 0; p < sizeof(policies) / sizeof(policies[0]); p++){
+            const struct TEST_POLICY *policy = &policies[p];
+            int engine_faults;
+            int scan_faults_cnt;
+
+            clear_table(engine_table, table_cnt, engine_pool, frame_cnt);
+            clear_table(scan_table, table_cnt, scan_pool, frame_cnt);
+            engine_faults = policy->count(engine_table, table_cnt, reference_string, reference_cnt, engine_pool, frame_cnt);
+            scan_faults_cnt = scan_faults(policy, scan_table, table_cnt, reference_string, reference_cnt, scan_pool, frame_cnt);
+            if(engine_faults != scan_faults_cnt){
+                fail("faults of", policy->name, round, scan_faults_cnt, engine_faults);
+                continue;
+            }
+            for(int i = 0; i < table_cnt; i++){
+                if(memcmp(&engine_table[i], &scan_table[i], sizeof(struct PTE)) != 0){
+                    fail("page table entry of", policy->name, round, i, i);
+                    break;
+                }
+            }
+        }
+    }
+}
+
+static void trace_write(FILE *out, int format, long long page_number)
+{
+    //page_number in the given TRACE_ format, texts separated by a mix of separators
+    switch(format){
+    case TRACE_U32:
+    case TRACE_U64:
+        for(int i = 0; i < (format == TRACE_U32 ? 4 : 8); i++){
+            fputc((int)((unsigned long long)page_number >> (8 * i) & 0xff), out);
+        }
+        break;
+    case TRACE_TEXT:
+        fprintf(out, "%lld%s", page_number, xorshift64(&rng_state) % 2 ? "\n" : ", ");
+        break;
+    default:
+        do {
+            fputc((int)(page_number & 0x7f) | (page_number > 0x7f ? 0x80 : 0), out);
+            page_number >>= 7;
+        } while(page_number > 0);
+        break;
+    }
+}
+
+static int trace_faults(struct PAGE_CONTEXT *ctx, int policy, int frame_cnt, const char *path, int fd, int format)
+{
+    //count_page_faults_trace from a fresh start, through a mapped path or else a descriptor read in chunks
+    struct TRACE_READER trace;
+    long long page_faults;
+
+    page_context_reset(ctx, policy, frame_cnt);
+    if((path != NULL ? trace_open(&trace, path, format) : trace_open_fd(&trace, fd, format)) != 0){
+        return -1;
+    }
+    page_faults = count_page_faults_trace(ctx, &trace);
+    trace_close(&trace);
+    return (int)page_faults;
+}
+
+static void check_trace(int rounds)
+{
+    /*Writes random strings in each TRACE_ format and expects count_page_faults_trace to fault like
+page_context_run on the same string, whether the file is mapped or read in chunks. Malformed text and
+a run that would take the timestamp past INT_MAX must fail.*/
+    static int reference_string[TEST_REFS_MAX];
+    static const char *bad_text[] = { "1 -2", "3 99999999999999999999" };
+    char path[] = "oslabs_test_XXXXXX";
+    int fd = mkstemp(path);
+    FILE *out;
+    struct PAGE_CONTEXT *ctx = page_context_create(TEST_TABLE_MAX, TEST_TABLE_MAX, POLICY_LRU);
+    struct TRACE_READER trace;
+    long long page_number;
+
+    if(fd == -1 || ctx == NULL || (out = fdopen(fd, "w+")) == NULL){
+        fail("trace file of", "trace", 0, 0, -1);
+        page_context_destroy(ctx);
+        return;
+    }
+    for(int round = 0; round < rounds; round++){
+        int format = (int)(xorshift64(&rng_state) % 4);
+        int frame_cnt = 1 + (int)(xorshift64(&rng_state) % TEST_TABLE_MAX);
+        int reference_cnt = random_string(reference_string, TEST_TABLE_MAX);
+        int expected;
+        int got;
+
+        rewind(out);
+        ftruncate(fd, 0);
+        for(int i = 0; i < reference_cnt; i++){
+            trace_write(out, format, reference_string[i]);
+        }
+        fflush(out);
+        page_context_reset(ctx, POLICY_LRU, frame_cnt);
+        expected = page_context_run(ctx, reference_string, reference_cnt);
+        got = trace_faults(ctx, POLICY_LRU, frame_cnt, path, -1, format);
+        if(got != expected){
+            fail("faults of", "mapped trace", round, expected, got);
+        }
+        lseek(fd, 0, SEEK_SET);
+        got = trace_faults(ctx, POLICY_LRU, frame_cnt, NULL, fd, format);
+        if(got != expected){
+            fail("faults of", "trace read in chunks", round, expected, got);
+        }
+    }
+    for(size_t b = 0; b < sizeof(bad_text) / sizeof(bad_text[0]); b++){
+        int got;
+
+        rewind(out);
+        ftruncate(fd, 0);
+        fputs(bad_text[b], out);
+        fflush(out);
+        trace_open(&trace, path, TRACE_TEXT);
+        while((got = trace_next(&trace, &page_number)) == 1){
+        }
+        trace_close(&trace);
+        if(got != -1){
+            fail("malformed text", bad_text[b], (int)b, -1, got);
+        }
+    }
+    page_context_reset(ctx, POLICY_LRU, 1);
+    ctx->timestamp = INT_MAX - 1;
+    if(page_context_run(ctx, reference_string, 2) != -1 || ctx->timestamp != INT_MAX || ctx->page_faults != 1){
+        fail("run past INT_MAX of", "trace", 0, -1, ctx->timestamp);
+    }
+    fclose(out);
+    unlink(path);
+    page_context_destroy(ctx);
+}
+
+static void check_curve(int rounds)
+{
+    //one pass of stack distances against count_page_faults_lru at every frame count
+    static struct PTE page_table[TEST_TABLE_MAX];
+    static int frame_pool[TEST_TABLE_MAX];
+    static int reference_string[TEST_REFS_MAX];
+    static long long curve[TEST_TABLE_MAX];
+
+    for(int round = 0; round < rounds; round++){
+        int table_cnt = 1 + (int)(xorshift64(&rng_state) % TEST_TABLE_MAX);
+        int reference_cnt = (int)(xorshift64(&rng_state) % TEST_REFS_MAX);
+
+        for(int i = 0; i < reference_cnt; i++){
+            reference_string[i] = (int)(xorshift64(&rng_state) % (unsigned long long)table_cnt);
+        }
+        if(count_page_faults_lru_curve(reference_string, reference_cnt, table_cnt, curve, table_cnt) != 0){
+            fail("curve status of", "lru", round, 0, -1);
+            continue;
+        }
+        for(int f = 1; f <= table_cnt; f++){
+            int faults;
+
+            clear_table(page_table, table_cnt, frame_pool, f);
+            faults = count_page_faults_lru(page_table, table_cnt, reference_string, reference_cnt, frame_pool, f);
+            if(curve[f - 1] != faults){
+                fail("curve point of", "lru", round, faults, curve[f - 1]);
+                break;
+            }
+        }
+    }
+}
+
+static void check_fixed(int rounds)
+{
+    /*Counts worked out by hand. Belady's string shows FIFO's anomaly and LRU's stack property. On the
+second string LRU keeps page 1, which its hit made recent, where FIFO replaces it. On the third every
+page is referenced once when page 4 comes in, so LFU replaces page 1, the earliest to arrive.*/
+    (void)rounds;
+    static const struct {
+        int policy;
+        int frame_cnt;
+        int reference_cnt;
+        int reference_string[12];
+        int page_faults;
+        int replaced_page; //not in memory at the end
+    } cases[] = {
+        { 0, 3, 12, { 1, 2, 3, 4, 1, 2, 5, 1, 2, 3, 4, 5 }, 9, 1 },
+        { 0, 4, 12, { 1, 2, 3, 4, 1, 2, 5, 1, 2, 3, 4, 5 }, 10, 1 },
+        { 1, 3, 12, { 1, 2, 3, 4, 1, 2, 5, 1, 2, 3, 4, 5 }, 10, 1 },
+        { 1, 4, 12, { 1, 2, 3, 4, 1, 2, 5, 1, 2, 3, 4, 5 }, 8, 1 },
+        { 0, 3, 5, { 1, 2, 3, 1, 4 }, 4, 1 },
+        { 1, 3, 5, { 1, 2, 3, 1, 4 }, 4, 2 },
+        { 2, 3, 4, { 1, 2, 3, 4 }, 4, 1 },
+        { 2, 3, 6, { 1, 2, 2, 3, 1, 4 }, 4, 3 },
+    };
+    struct PTE page_table[8];
+    int frame_pool[8];
+
+    for(size_t c = 0; c < sizeof(cases) / sizeof(cases[0]); c++){
+        const struct TEST_POLICY *policy = &policies[cases[c].policy];
+        int faults;
+
+        clear_table(page_table, 8, frame_pool, cases[c].frame_cnt);
+        faults = policy->count(page_table, 8, (int *)cases[c].reference_string, cases[c].reference_cnt, frame_pool, cases[c].frame_cnt);
+        if(faults != cases[c].page_faults){
+            fail("fixed faults of", policy->name, (int)c, cases[c].page_faults, faults);
+        }
+        if(page_table[cases[c].replaced_page].is_valid != 0){
+            fail("fixed replaced page of", policy->name, (int)c, cases[c].replaced_page, -1);
+        }
+    }
+}
+
+static void check_context(int rounds)
+{
+    /*A context run in two halves, the second through page_context_attach on the table the first left
+behind, must fault as often as one uninterrupted run of a context of any size. page_context_reset
+between the two runs must leave nothing of the first behind.*/
+    static int reference_string[TEST_REFS_MAX];
+
+    for(int round = 0; round < rounds; round++){
+        int table_cnt = 1 + (int)(xorshift64(&rng_state) % (4 * TEST_TABLE_MAX));
+        int frame_cnt = 1 + (int)(xorshift64(&rng_state) % (unsigned long long)table_cnt);
+        int reference_cnt = random_string(reference_string, table_cnt);
+        int half = reference_cnt / 2;
+
+        for(size_t p = 0; p < sizeof(policies) / sizeof(policies[0]); p++){
+            struct PAGE_CONTEXT *ctx = page_context_create(table_cnt, frame_cnt, policies[p].policy);
+            struct PAGE_CONTEXT *rest;
+            int whole;
+            int halves;
+
+            if(ctx == NULL){
+                fail("context of", policies[p].name, round, 0, -1);
+                continue;
+            }
+            whole = page_context_run(ctx, reference_string, reference_cnt);
+            page_context_reset(ctx, policies[p].policy, frame_cnt);
+            halves = page_context_run(ctx, reference_string, half);
+            rest = page_context_attach(ctx->page_table, table_cnt, ctx->frame_pool, ctx->frame_cnt, policies[p].policy);
+            if(rest == NULL){
+                fail("attached context of", policies[p].name, round, 0, -1);
+                page_context_destroy(ctx);
+                continue;
+            }
+            rest->timestamp = ctx->timestamp;
+            halves += page_context_run(rest, reference_string + half, reference_cnt - half);
+            if(whole != halves){
+                fail("faults in two halves of", policies[p].name, round, whole, halves);
+            }
+            page_context_destroy(rest);
+            page_context_destroy(ctx);
+        }
+    }
+}
+
+static void check_sweep(int rounds)
+{
+    /*sweep_run on several threads must give every job the faults and hits of a serial
+count_page_faults_* run of the same policy on the job's own trace. The workers' contexts are sized
+for the largest trace, so this also covers running a string on a larger table than it needs.*/
+    static int reference_strings[3][TEST_REFS_MAX];
+    static struct SWEEP_JOB jobs[7 * 3 * 3];
+    static struct SWEEP_RESULT results[7 * 3 * 3];
+    static struct PTE page_table[TEST_TABLE_MAX];
+    static int frame_pool[TEST_TABLE_MAX];
+    struct SWEEP_TRACE traces[3];
+
+    for(int round = 0; round < MAX(1, rounds / 10); round++){
+        int job_cnt = 0;
+
+        for(int t = 0; t < 3; t++){
+            traces[t].reference_string = reference_strings[t];
+            traces[t].table_cnt = 1 + (int)(xorshift64(&rng_state) % TEST_TABLE_MAX);
+            traces[t].reference_cnt = random_string(reference_strings[t], traces[t].table_cnt);
+            for(int policy = 0; policy < 7; policy++){
+                for(int f = 0; f < 3; f++){
+                    jobs[job_cnt].policy = policy;
+                    jobs[job_cnt].frame_cnt = 1 + (int)(xorshift64(&rng_state) % (unsigned long long)traces[t].table_cnt);
+                    jobs[job_cnt].trace = t;
+                    job_cnt++;
+                }
+            }
+        }
+        if(sweep_run(traces, 3, jobs, job_cnt, results, 4) != 0){
+            fail("status of", "sweep", round, 0, -1);
+            continue;
+        }
+        for(int j = 0; j < job_cnt; j++){
+            struct SWEEP_TRACE *trace = &traces[jobs[j].trace];
+            int faults;
+
+            clear_table(page_table, trace->table_cnt, frame_pool, jobs[j].frame_cnt);
+            faults = policy_counts[jobs[j].policy](page_table, trace->table_cnt, trace->reference_string, trace->reference_cnt, frame_pool,
+                jobs[j].frame_cnt);
+            if(results[j].page_faults != faults || results[j].page_hits != trace->reference_cnt - faults){
+                fail("faults of sweep job", "sweep", round, faults, results[j].page_faults);
+            }
+        }
+    }
+}
+
+static void check_ghost(int rounds)
+{
+    /*ARC and 2Q on strings worked out by hand. With 2 frames, ARC sends page 2 to b1 when page 3 comes
+in, its ghost hit raises the target to 1 so page 1 goes from t2 to b2, and page 1's ghost hit lowers
+the target back to 0 and evicts page 3. With 4 frames, 2Q's a1in may hold 1 page, so page 5 pushes
+page 1 onto a1out and page 1 comes back onto am, pushing out page 2. The scan string gives pages 0 to 3
+a second reference (on t2 for ARC, through a1out onto am for 2Q) and then reads 100 pages once. ARC
+and 2Q keep pages 0 to 3 through the scan, LRU loses them.*/
+    static const struct {
+        int policy;
+        int frame_cnt;
+        int reference_cnt;
+        int reference_string[7];
+        int page_faults;
+        int ghost_hits;
+        int replaced_page; //not in memory at the end
+    } cases[] = {
+        { POLICY_ARC, 2, 6, { 1, 2, 1, 3, 2, 1 }, 5, 2, 3 },
+        { POLICY_2Q, 4, 7, { 1, 2, 3, 4, 1, 5, 1 }, 6, 1, 2 },
+    };
+    static const int scan_policies[] = { POLICY_LRU, POLICY_ARC, POLICY_2Q };
+    static const int hot_faults[] = { 4, 0, 0 };
+    int scan[8 + 8 + 4 + 100 + 4];
+    int scan_cnt = 0;
+
+    (void)rounds;
+    for(size_t c = 0; c < sizeof(cases) / sizeof(cases[0]); c++){
+        struct PAGE_CONTEXT *ctx = page_context_create(8, cases[c].frame_cnt, cases[c].policy);
+        int faults;
+
+        if(ctx == NULL){
+            fail("context of", "ghost", (int)c, 0, -1);
+            continue;
+        }
+        faults = page_context_run(ctx, (int *)cases[c].reference_string, cases[c].reference_cnt);
+        if(faults != cases[c].page_faults){
+            fail("fixed faults of", "ghost", (int)c, cases[c].page_faults, faults);
+        }
+        if(ctx->ghost_hits != cases[c].ghost_hits){
+            fail("fixed ghost hits of", "ghost", (int)c, cases[c].ghost_hits, ctx->ghost_hits);
+        }
+        if(ctx->page_table[cases[c].replaced_page].is_valid != 0){
+            fail("fixed replaced page of", "ghost", (int)c, cases[c].replaced_page, -1);
+        }
+        page_context_destroy(ctx);
+    }
+    for(int pass = 0; pass < 2; pass++){
+        for(int i = 0; i < 4; i++){
+            scan[scan_cnt++] = i;
+        }
+    }
+    for(int i = 0; i < 8; i++){
+        scan[scan_cnt++] = 20 + i;
+    }
+    for(int i = 0; i < 4; i++){
+        scan[scan_cnt++] = i;
+    }
+    for(int i = 0; i < 100; i++){
+        scan[scan_cnt++] = 100 + i;
+    }
+    for(int i = 0; i < 4; i++){
+        scan[scan_cnt++] = i;
+    }
+    for(size_t p = 0; p < sizeof(scan_policies) / sizeof(scan_policies[0]); p++){
+        struct PAGE_CONTEXT *ctx = page_context_create(200, 8, scan_policies[p]);
+        int faults;
+
+        if(ctx == NULL){
+            fail("context of", "ghost scan", (int)p, 0, -1);
+            continue;
+        }
+        page_context_run(ctx, scan, scan_cnt - 4);
+        faults = page_context_run(ctx, scan + scan_cnt - 4, 4);
+        if(faults != hot_faults[p]){
+            fail("faults on the hot pages after a scan of", "ghost scan", (int)p, hot_faults[p], faults);
+        }
+        page_context_destroy(ctx);
+    }
+}
+
+static void check_opt(int rounds)
+{
+    /*OPT faults 7 times on Belady's string with 3 frames, and on random strings no policy faults less
+often than OPT at any frame count.*/
+    static int belady[12] = { 1, 2, 3, 4, 1, 2, 5, 1, 2, 3, 4, 5 };
+    static struct PTE page_table[TEST_TABLE_MAX];
+    static int frame_pool[TEST_TABLE_MAX];
+    static int reference_string[TEST_REFS_MAX];
+    int faults;
+
+    clear_table(page_table, 8, frame_pool, 3);
+    faults = count_page_faults_opt(page_table, 8, belady, 12, frame_pool, 3);
+    if(faults != 7){
+        fail("faults on Belady's string of", "opt", 0, 7, faults);
+    }
+    for(int round = 0; round < MAX(1, rounds / 10); round++){
+        int table_cnt = 1 + (int)(xorshift64(&rng_state) % TEST_TABLE_MAX);
+        int reference_cnt = random_string(reference_string, table_cnt);
+
+        for(int f = 1; f <= table_cnt; f++){
+            int opt_faults;
+
+            clear_table(page_table, table_cnt, frame_pool, f);
+            opt_faults = count_page_faults_opt(page_table, table_cnt, reference_string, reference_cnt, frame_pool, f);
+            for(size_t p = 0; p < sizeof(policy_counts) / sizeof(policy_counts[0]); p++){
+                clear_table(page_table, table_cnt, frame_pool, f);
+                faults = policy_counts[p](page_table, table_cnt, reference_string, reference_cnt, frame_pool, f);
+                if(opt_faults < 0 || faults < opt_faults){
+                    fail("faults below OPT of policy", "opt", round, opt_faults, faults);
+                }
+            }
+        }
+    }
+}
+
+static void check_soa(int rounds)
+{
+    /*process_page_access_soa with every kernel this build and processor can run must return the frames
+of the scan-based process_page_access_* on the same string and leave the same page table. Some pages
+are loaded by page_context_prefetch, with a reference_count of 0, which LFU must rank with the pages
+referenced once.*/
+    static const int soa_policies[] = { POLICY_FIFO, POLICY_LRU, POLICY_LFU };
+    static struct PTE page_table[TEST_TABLE_MAX];
+    static struct PTE soa_table[TEST_TABLE_MAX];
+    static int frame_pool[TEST_TABLE_MAX];
+    static int soa_pool[TEST_TABLE_MAX];
+    static int reference_string[TEST_REFS_MAX];
+
+    for(int round = 0; round < rounds; round++){
+        int table_cnt = 1 + (int)(xorshift64(&rng_state) % TEST_TABLE_MAX);
+        int frame_cnt = 1 + (int)(xorshift64(&rng_state) % (unsigned long long)table_cnt);
+        int reference_cnt = random_string(reference_string, table_cnt);
+        struct PTE_TABLE *pt = pte_table_create(table_cnt);
+
+        if(pt == NULL){
+            fail("table of", "soa", round, 0, -1);
+            continue;
+        }
+        for(size_t p = 0; p < sizeof(soa_policies) / sizeof(soa_policies[0]); p++){
+            for(int kernel = PTE_KERNEL_SCALAR; kernel <= pte_table_best_kernel(); kernel++){
+                struct PAGE_CONTEXT view;
+                int free_cnt = frame_cnt;
+                int soa_free_cnt = frame_cnt;
+
+                clear_table(page_table, table_cnt, frame_pool, frame_cnt);
+                clear_table(soa_table, table_cnt, soa_pool, frame_cnt);
+                pte_table_load(pt, soa_table);
+                pt->kernel = kernel;
+                for(int i = 0; i < reference_cnt; i++){
+                    int page = reference_string[i];
+                    int prefetch = page_table[page].is_valid == 0 && xorshift64(&rng_state) % 4 == 0;
+                    int frame_number;
+                    int soa_frame_number = process_page_access_soa(pt, soa_policies[p], page, soa_pool, &soa_free_cnt, i + 1);
+
+                    page_context_view(&view, page_table, table_cnt, frame_pool, free_cnt, soa_policies[p]);
+                    frame_number = (prefetch ? page_context_prefetch : page_context_access)(&view, page, i + 1);
+                    free_cnt = view.frame_cnt;
+                    if(prefetch){
+                        pt->reference_count[page] = 0; //loaded but not referenced, as the prefetch left it
+                    }
+                    if(frame_number != soa_frame_number){
+                        fail("frame of kernel", "soa", round, frame_number, soa_frame_number);
+                        break;
+                    }
+                }
+                pte_table_store(pt, soa_table);
+                if(memcmp(page_table, soa_table, (size_t)table_cnt * sizeof(struct PTE)) != 0){
+                    fail("page table of kernel", "soa", round, kernel, kernel);
+                }
+            }
+        }
+        pte_table_destroy(pt);
+    }
+}
+
+static void check_manager(int rounds)
+{
+    /*A manager with one process must fault like a plain context on the same string, under either scope,
+and leave the same page table. Under SCOPE_LOCAL each of several processes only ever replaces its own
+pages within its quota, so each must fault like a context with quota frames run on just its own
+references.*/
+    static const int manager_policies[] = { POLICY_FIFO, POLICY_LRU, POLICY_CLOCK };
+    static int reference_string[TEST_REFS_MAX];
+    static int process_ids[TEST_REFS_MAX];
+    static int own_string[TEST_REFS_MAX];
+
+    for(int round = 0; round < rounds; round++){
+        int table_cnts[3];
+        int pool_cnt;
+        int reference_cnt;
+
+        table_cnts[0] = 1 + (int)(xorshift64(&rng_state) % TEST_TABLE_MAX);
+        pool_cnt = 1 + (int)(xorshift64(&rng_state) % (unsigned long long)table_cnts[0]);
+        reference_cnt = random_string(reference_string, table_cnts[0]);
+        for(size_t p = 0; p < sizeof(manager_policies) / sizeof(manager_policies[0]); p++){
+            for(int scope = SCOPE_GLOBAL; scope <= SCOPE_LOCAL; scope++){
+                struct MEMORY_MANAGER *mm = memory_manager_create(1, table_cnts, pool_cnt, manager_policies[p], scope);
+                struct PAGE_CONTEXT *ctx = page_context_create(table_cnts[0], pool_cnt, manager_policies[p]);
+                long long faults;
+                int expected;
+
+                if(mm == NULL || ctx == NULL){
+                    fail("manager of", "manager", round, 0, -1);
+                    memory_manager_destroy(mm);
+                    page_context_destroy(ctx);
+                    continue;
+                }
+                for(int i = 0; i < reference_cnt; i++){
+                    process_ids[i] = 0;
+                }
+                faults = memory_manager_run(mm, process_ids, reference_string, reference_cnt);
+                expected = page_context_run(ctx, reference_string, reference_cnt);
+                if(faults != expected || mm->processes[0].page_faults != expected){
+                    fail("faults of one process under scope", "manager", round, expected, faults);
+                }
+                else if(memcmp(mm->page_table, ctx->page_table, (size_t)table_cnts[0] * sizeof(struct PTE)) != 0){
+                    fail("page table of one process under scope", "manager", round, scope, scope);
+                }
+                memory_manager_destroy(mm);
+                page_context_destroy(ctx);
+            }
+        }
+        for(int pid = 0; pid < 3; pid++){
+            table_cnts[pid] = 1 + (int)(xorshift64(&rng_state) % TEST_TABLE_MAX);
+        }
+        pool_cnt = 3 + (int)(xorshift64(&rng_state) % TEST_TABLE_MAX);
+        reference_cnt = (int)(xorshift64(&rng_state) % TEST_REFS_MAX);
+        for(int i = 0; i < reference_cnt; i++){
+            process_ids[i] = (int)(xorshift64(&rng_state) % 3);
+            reference_string[i] = (int)(xorshift64(&rng_state) % (unsigned long long)table_cnts[process_ids[i]]);
+        }
+        for(size_t p = 0; p < sizeof(manager_policies) / sizeof(manager_policies[0]); p++){
+            struct MEMORY_MANAGER *mm = memory_manager_create(3, table_cnts, pool_cnt, manager_policies[p], SCOPE_LOCAL);
+
+            if(mm == NULL || memory_manager_run(mm, process_ids, reference_string, reference_cnt) == -1){
+                fail("local run of", "manager", round, 0, -1);
+                memory_manager_destroy(mm);
+                continue;
+            }
+            for(int pid = 0; pid < 3; pid++){
+                struct PAGE_CONTEXT *ctx = page_context_create(table_cnts[pid], mm->processes[pid].quota, manager_policies[p]);
+                int own_cnt = 0;
+                int expected;
+
+                for(int i = 0; i < reference_cnt; i++){
+                    if(process_ids[i] == pid){
+                        own_string[own_cnt++] = reference_string[i];
+                    }
+                }
+                expected = ctx != NULL ? page_context_run(ctx, own_string, own_cnt) : -1;
+                if(mm->processes[pid].page_faults != expected){
+                    fail("faults of a process under a local quota", "manager", round, expected, mm->processes[pid].page_faults);
+                }
+                page_context_destroy(ctx);
+            }
+            memory_manager_destroy(mm);
+        }
+    }
+}
+
+static int tlb_coherent(struct TLB *tlb, struct PAGE_CONTEXT *ctx, int resident_only)
+{
+    /*1 if no entry translates a page in memory to another frame and, when resident_only is set, every
+entry's page is in memory*/
+    for(int i = 0; i < tlb->entry_cnt; i++){
+        int page = tlb->page_number[i];
+
+        if(page == -1){
+            continue;
+        }
+        if(ctx->page_table[page].is_valid == 0 ? resident_only : ctx->page_table[page].frame_number != tlb->frame_number[i]){
+            return 0;
+        }
+    }
+    return 1;
+}
+
+static void check_tlb(int rounds)
+{
+    /*A context behind a TLB must return the frames and fault counts of one without, under every policy
+and TLB shape. Shootdowns must keep every entry's page in memory in the entry's frame. After a
+page_context_reset that leaves the TLB alone, entries for pages not yet referenced again are stale
+and must miss rather than return their old frame. On a fixed string with 2 frames, page 1 is in frame
+0 before the reset and frame 1 after, and the lookup must shoot the old entry down.*/
+    static int reference_string[TEST_REFS_MAX];
+    static const int fixed[3] = { 0, 1, 1 };
+    struct PAGE_CONTEXT *ctx;
+    struct TLB *tlb;
+    int frame_number;
+
+    for(int round = 0; round < rounds; round++){
+        int table_cnt = 1 + (int)(xorshift64(&rng_state) % TEST_TABLE_MAX);
+        int frame_cnt = 1 + (int)(xorshift64(&rng_state) % (unsigned long long)table_cnt);
+        int ways = 1 + (int)(xorshift64(&rng_state) % 4);
+        int entry_cnt = ways * (1 + (int)(xorshift64(&rng_state) % 8));
+        int reference_cnt = random_string(reference_string, table_cnt);
+        int policy = (int)(xorshift64(&rng_state) % 7);
+        struct PAGE_CONTEXT *plain = page_context_create(table_cnt, frame_cnt, policy);
+
+        ctx = page_context_create(table_cnt, frame_cnt, policy);
+        tlb = tlb_create(entry_cnt, ways, (int)(xorshift64(&rng_state) % 3));
+        if(plain == NULL || ctx == NULL || tlb == NULL){
+            fail("TLB of", "tlb", round, 0, -1);
+            page_context_destroy(plain);
+            page_context_destroy(ctx);
+            tlb_destroy(tlb);
+            continue;
+        }
+        for(int pass = 0; pass < 2; pass++){
+            for(int i = 0; i < reference_cnt; i++){
+                int expected = page_context_access(plain, reference_string[i], i + 1);
+
+                frame_number = page_context_access_tlb(tlb, ctx, reference_string[i], i + 1);
+                if(frame_number != expected){
+                    fail("frame behind the TLB, pass", "tlb", round, expected, frame_number);
+                    break;
+                }
+                if(!tlb_coherent(tlb, ctx, pass == 0)){
+                    fail("TLB entries after a shootdown, pass", "tlb", round, pass, -1);
+                    break;
+                }
+            }
+            if(ctx->page_faults != plain->page_faults || tlb->hits + tlb->misses != (long long)(pass + 1) * reference_cnt){
+                fail("faults behind the TLB, pass", "tlb", round, plain->page_faults, ctx->page_faults);
+            }
+            page_context_reset(plain, policy, frame_cnt);
+            page_context_reset(ctx, policy, frame_cnt); //the TLB keeps its entries
+        }
+        page_context_destroy(plain);
+        page_context_destroy(ctx);
+        tlb_destroy(tlb);
+    }
+    ctx = page_context_create(4, 2, POLICY_LRU);
+    tlb = tlb_create(4, 4, TLB_REPLACE_LRU);
+    if(ctx == NULL || tlb == NULL){
+        fail("TLB of", "tlb", 0, 0, -1);
+    }
+    else {
+        page_context_run_tlb(tlb, ctx, (int *)fixed, 2, NULL);
+        page_context_reset(ctx, POLICY_LRU, 2);
+        frame_number = page_context_access_tlb(tlb, ctx, fixed[2], 1);
+        if(frame_number != 1 || tlb->shootdowns != 1 || tlb->hits != 0 || tlb->misses != 3){
+            fail("frame after a reset behind the TLB", "tlb", 0, 1, frame_number);
+        }
+    }
+    page_context_destroy(ctx);
+    tlb_destroy(tlb);
+}
+
+static void check_sparse(int rounds)
+{
+    /*A sparse table must return the frames and faults of a flat table for the same pages, spread out
+over the 63-bit page space in the same order, under every policy it supports. Its entries must then
+be exactly the flat table's pages in memory.*/
+    static int reference_string[TEST_REFS_MAX];
+
+    for(int round = 0; round < rounds; round++){
+        int table_cnt = 1 + (int)(xorshift64(&rng_state) % TEST_TABLE_MAX);
+        int frame_cnt = 1 + (int)(xorshift64(&rng_state) % (unsigned long long)table_cnt);
+        int reference_cnt = random_string(reference_string, table_cnt);
+
+        for(size_t p = 0; p < sizeof(policies) / sizeof(policies[0]); p++){
+            struct PAGE_CONTEXT *flat = page_context_create(table_cnt, frame_cnt, policies[p].policy);
+            struct SPARSE_TABLE *st = sparse_table_create(frame_cnt, policies[p].policy);
+
+            if(flat == NULL || st == NULL){
+                fail("tables of", policies[p].name, round, 0, -1);
+                page_context_destroy(flat);
+                sparse_table_destroy(st);
+                continue;
+            }
+            for(int i = 0; i < reference_cnt; i++){
+                long long page_number = (1LL << 40) + reference_string[i] * 7919LL;
+                int expected = page_context_access(flat, reference_string[i], i + 1);
+                int frame_number = sparse_table_access(st, page_number, i + 1);
+
+                if(frame_number != expected){
+                    fail("sparse frame of", policies[p].name, round, expected, frame_number);
+                    break;
+                }
+            }
+            if(st->ctx->page_faults != flat->page_faults){
+                fail("sparse faults of", policies[p].name, round, flat->page_faults, st->ctx->page_faults);
+            }
+            for(int i = 0; i < table_cnt; i++){
+                struct PTE *entry = sparse_table_lookup(st, (1LL << 40) + i * 7919LL);
+
+                if(entry == NULL ? flat->page_table[i].is_valid != 0 : entry->frame_number != flat->page_table[i].frame_number
+                    || flat->page_table[i].is_valid == 0){
+                    fail("sparse entry of", policies[p].name, round, i, -1);
+                    break;
+                }
+            }
+            page_context_destroy(flat);
+            sparse_table_destroy(st);
+        }
+    }
+}
+
+static void check_allocator(int rounds)
+{
+    /*The indexed allocator must hand out the blocks the *_fit_allocate functions do and keep the same
+map, over random allocations with every fit and releases of allocated and unallocated addresses.*/
+    static struct MEMORY_BLOCK memory_map[TEST_MAP_MAX];
+    static struct MEMORY_BLOCK exported[TEST_MAP_MAX];
+    static const char *const fit_names[] = { "first", "next", "best", "worst" };
+
+    for(int round = 0; round < rounds; round++){
+        int memory_size = 1 + (int)(xorshift64(&rng_state) % (TEST_MAP_MAX - 1));
+        struct MEMORY_ALLOCATOR *ma = memory_allocator_create(memory_size, TEST_MAP_MAX);
+        int map_cnt = 1;
+        int last_address = 0;
+
+        if(ma == NULL){
+            fail("allocator of", "memory", round, 0, -1);
+            continue;
+        }
+        memory_map[0].start_address = 0;
+        memory_map[0].end_address = memory_size - 1;
+        memory_map[0].segment_size = memory_size;
+        memory_map[0].process_id = 0;
+        for(int step = 0; step < 200; step++){
+            int fit = (int)(xorshift64(&rng_state) % 4);
+            struct MEMORY_BLOCK expected;
+            struct MEMORY_BLOCK got;
+            int export_cnt;
+
+            if(xorshift64(&rng_state) % 3 == 0){
+                struct MEMORY_BLOCK freed_block = memory_map[xorshift64(&rng_state) % (unsigned long long)map_cnt];
+                int released = -1;
+                int result;
+
+                if(xorshift64(&rng_state) % 4 == 0){
+                    freed_block.start_address = (int)(xorshift64(&rng_state) % (unsigned long long)memory_size);
+                }
+                for(int i = 0; i < map_cnt; i++){
+                    if(memory_map[i].start_address == freed_block.start_address && memory_map[i].process_id != 0){
+                        released = 0;
+                    }
+                }
+                release_memory(freed_block, memory_map, &map_cnt);
+                result = memory_allocator_release(ma, freed_block);
+                if(result != released){
+                    fail("release of", "memory", round, released, result);
+                }
+            }
+            else {
+                int request_size = 1 + (int)(xorshift64(&rng_state) % (unsigned long long)(memory_size / 2 + 1));
+                int process_id = 1 + step;
+
+                switch(fit){
+                case FIT_FIRST:
+                    expected = first_fit_allocate(request_size, memory_map, &map_cnt, process_id);
+                    break;
+                case FIT_NEXT:
+                    expected = next_fit_allocate(request_size, memory_map, &map_cnt, process_id, last_address);
+                    break;
+                case FIT_BEST:
+                    expected = best_fit_allocate(request_size, memory_map, &map_cnt, process_id);
+                    break;
+                default:
+                    expected = worst_fit_allocate(request_size, memory_map, &map_cnt, process_id);
+                    break;
+                }
+                if(expected.process_id != 0){
+                    last_address = expected.start_address;
+                }
+                got = memory_allocator_allocate(ma, fit, request_size, process_id);
+                if(memcmp(&got, &expected, sizeof(got)) != 0){
+                    fail("allocated start of", fit_names[fit], round, expected.start_address, got.start_address);
+                }
+            }
+            export_cnt = memory_allocator_export(ma, exported, TEST_MAP_MAX);
+            if(export_cnt != map_cnt){
+                fail("block count of", fit_names[fit], round, map_cnt, export_cnt);
+                break;
+            }
+            if(memcmp(exported, memory_map, (size_t)map_cnt * sizeof(memory_map[0])) != 0){
+                fail("map of", fit_names[fit], round, map_cnt, export_cnt);
+                break;
+            }
+        }
+        memory_allocator_destroy(ma);
+    }
+}
+
+static void check_disk(int rounds)
+{
+    /*A DISK_QUEUE must serve the requests the handle_request_completion_* functions pick from the same
+array, with few cylinders and arrival times so ties are common, and the head following each pick so
+LOOK turns around whenever its pick lies behind it.*/
+    static struct RCB request_queue[TEST_QUEUE_MAX];
+    static const char *const disk_names[] = { "fcfs", "sstf", "look" };
+    struct RCB busy = { 1, 0, 0, 0, 1 };
+    long long turns = 0;
+    long long ties = 0;
+
+    for(int round = 0; round < rounds; round++){
+        for(int policy = DISK_FCFS; policy <= DISK_LOOK; policy++){
+            struct DISK_QUEUE *dq = disk_queue_create(policy, 1);
+            int cylinder_cnt = 1 + (int)(xorshift64(&rng_state) % 16);
+            int queue_cnt = 0;
+            int head = (int)(xorshift64(&rng_state) % (unsigned long long)cylinder_cnt);
+            int scan_direction = 1;
+
+            if(dq == NULL){
+                fail("queue of", disk_names[policy], round, 0, -1);
+                continue;
+            }
+            for(int step = 0; step < 400; step++){
+                struct RCB expected;
+                struct RCB got;
+
+                if(queue_cnt < TEST_QUEUE_MAX - 1 && xorshift64(&rng_state) % 2 == 0){
+                    struct RCB new_request;
+
+                    new_request.request_id = step + 1;
+                    new_request.arrival_timestamp = step / 4 + (int)(xorshift64(&rng_state) % 3);
+                    new_request.cylinder = (int)(xorshift64(&rng_state) % (unsigned long long)cylinder_cnt);
+                    new_request.address = new_request.cylinder * 100;
+                    new_request.process_id = 1;
+                    handle_request_arrival_fcfs(request_queue, &queue_cnt, busy, new_request, step);
+                    if(disk_queue_push(dq, new_request) != 0){
+                        fail("push of", disk_names[policy], round, 0, -1);
+                        break;
+                    }
+                    continue;
+                }
+                switch(policy){
+                case DISK_FCFS:
+                    expected = handle_request_completion_fcfs(request_queue, &queue_cnt);
+                    break;
+                case DISK_SSTF:
+                    expected = handle_request_completion_sstf(request_queue, &queue_cnt, head);
+                    break;
+                default:
+                    expected = handle_request_completion_look(request_queue, &queue_cnt, head, scan_direction);
+                    break;
+                }
+                got = disk_queue_pop(dq, head, scan_direction);
+                if(memcmp(&got, &expected, sizeof(got)) != 0){
+                    fail("request served by", disk_names[policy], round, expected.request_id, got.request_id);
+                    break;
+                }
+                for(int i = 0; i < queue_cnt; i++){
+                    ties += request_queue[i].cylinder == expected.cylinder; //the pick had to break a tie
+                }
+                if(expected.request_id != 0 && expected.cylinder != head){
+                    turns += policy == DISK_LOOK && scan_direction != (expected.cylinder > head);
+                    scan_direction = expected.cylinder > head;
+                    head = expected.cylinder;
+                }
+            }
+            if(dq->queue_cnt != queue_cnt){
+                fail("queue length of", disk_names[policy], round, queue_cnt, dq->queue_cnt);
+            }
+            disk_queue_destroy(dq);
+        }
+    }
+    if(rounds >= 10 && (turns == 0 || ties == 0)){
+        fail("turns and ties of", "disk", rounds, 1, MIN(turns, ties)); //the rounds never reached the cases that matter
+    }
+}
+
+static void check_cpu(int rounds)
+{
+    /*A READY_QUEUE must run the processes the handle_process_* functions do from the same arrivals and
+completions, with few priorities and burst times so ties are common, and cpu_replay must run a process
+whose fields are all 0 rather than take it for a failed push.*/
+    static struct PCB ready_queue[TEST_QUEUE_MAX];
+    static const char *const cpu_names[] = { "pp", "srtp", "rr" };
+
+    for(int policy = CPU_PP; policy <= CPU_RR; policy++){
+        struct PCB zero = { 0, 0, 0, 0, 0, 0, 0 };
+        struct CPU_STATS stats;
+        int status = cpu_replay(policy, &zero, 1, 1, &stats);
+
+        if(status != 0 || stats.processes != 1){
+            fail("zero process run by", cpu_names[policy], 0, 1, status != 0 ? status : stats.processes);
+        }
+    }
+    for(int round = 0; round < rounds; round++){
+        for(int policy = CPU_PP; policy <= CPU_RR; policy++){
+            struct READY_QUEUE *rq = ready_queue_create(policy, 1);
+            struct PCB expected = { 0, 0, 0, 0, 0, 0, 0 };
+            struct PCB got = expected;
+            int time_quantum = policy == CPU_RR ? 1 + (int)(xorshift64(&rng_state) % 3) : 0;
+            int queue_cnt = 0;
+            int now = 0;
+
+            if(rq == NULL){
+                fail("queue of", cpu_names[policy], round, 0, -1);
+                continue;
+            }
+            for(int step = 0; step < 400; step++){
+                if(queue_cnt < TEST_QUEUE_MAX - 1 && (expected.process_id == 0 || xorshift64(&rng_state) % 2 == 0)){
+                    struct PCB new_process = { 0, 0, 0, 0, 0, 0, 0 };
+
+                    if(expected.process_id != 0){
+                        now += (int)(xorshift64(&rng_state) % (unsigned long long)(expected.execution_endtime - now + 1));
+                    }
+                    new_process.process_id = step + 1;
+                    new_process.arrival_timestamp = now;
+                    new_process.total_bursttime = 1 + (int)(xorshift64(&rng_state) % 4);
+                    new_process.process_priority = (int)(xorshift64(&rng_state) % 3);
+                    switch(policy){
+                    case CPU_PP:
+                        expected = handle_process_arrival_pp(ready_queue, &queue_cnt, expected, new_process, now);
+                        break;
+                    case CPU_SRTP:
+                        expected = handle_process_arrival_srtp(ready_queue, &queue_cnt, expected, new_process, now);
+                        break;
+                    default:
+                        expected = handle_process_arrival_rr(ready_queue, &queue_cnt, expected, new_process, now, time_quantum);
+                        break;
+                    }
+                    got = ready_queue_arrival(rq, got, new_process, now, time_quantum);
+                }
+                else {
+                    now = expected.execution_endtime;
+                    expected.remaining_bursttime -= expected.execution_endtime - expected.execution_starttime;
+                    if(expected.remaining_bursttime > 0){
+                        expected.execution_endtime = 0; //its quantum ran out, only under RR
+                        ready_queue[queue_cnt++] = expected;
+                        if(ready_queue_push(rq, expected) != 0){
+                            fail("push of", cpu_names[policy], round, 0, -1);
+                            break;
+                        }
+                    }
+                    switch(policy){
+                    case CPU_PP:
+                        expected = handle_process_completion_pp(ready_queue, &queue_cnt, now);
+                        break;
+                    case CPU_SRTP:
+                        expected = handle_process_completion_srtp(ready_queue, &queue_cnt, now);
+                        break;
+                    default:
+                        expected = handle_process_completion_rr(ready_queue, &queue_cnt, now, time_quantum);
+                        break;
+                    }
+                    got = ready_queue_completion(rq, now, time_quantum);
+                }
+                if(memcmp(&got, &expected, sizeof(got)) != 0){
+                    fail("process run by", cpu_names[policy], round, expected.process_id, got.process_id);
+                    break;
+                }
+                if(rq->queue_cnt != queue_cnt){
+                    fail("queue length of", cpu_names[policy], round, queue_cnt, rq->queue_cnt);
+                    break;
+                }
+            }
+            ready_queue_destroy(rq);
+        }
+    }
+}
+
+static void resident_consistent(const char *name,
+int round,
+struct PTE page_table[],
+int table_cnt,
+int page_faults,
+long long phase_faults[],
+struct RESIDENT_STATS *stats)
+{
+    //every fault is counted once in a phase, and the pages left in memory are the faults less the replacements and releases
+    long long phase_sum = 0;
+    int resident = 0;
+
+    for(int i = 0; i < stats->phase_cnt; i++){
+        phase_sum += phase_faults[i];
+    }
+    for(int i = 0; i < table_cnt; i++){
+        resident += page_table[i].is_valid != 0;
+    }
+    if(stats->page_faults != page_faults || phase_sum != page_faults){
+        fail("phase faults of", name, round, page_faults, phase_sum);
+    }
+    if(resident != stats->page_faults - stats->replacements - stats->releases || resident > stats->max_resident){
+        fail("resident pages of", name, round, stats->page_faults - stats->replacements - stats->releases, resident);
+    }
+}
+
+static void check_workset(int rounds)
+{
+    /*With a window at least as long as the string the working set never loses a page, so it faults once
+per distinct page. With any window a reference faults exactly when its page was last referenced more
+than window references before, or never, and the set never holds more pages than the window. A longer
+window never faults more. PFF with an upper rate of 0 always gives a fault a new frame, so it faults
+once per distinct page too, and with any rates it faults at least that often.*/
+    static int reference_string[TEST_REFS_MAX];
+    static long long phase_faults[TEST_REFS_MAX];
+    struct PTE page_table[TEST_TABLE_MAX];
+    int frame_pool[TEST_TABLE_MAX];
+    struct RESIDENT_STATS stats;
+
+    for(int round = 0; round < rounds; round++){
+        int table_cnt = 1 + (int)(xorshift64(&rng_state) % TEST_TABLE_MAX);
+        int reference_cnt = random_string(reference_string, table_cnt);
+        int phase_length = 1 + (int)(xorshift64(&rng_state) % 50);
+        int window = 1 + (int)(xorshift64(&rng_state) % (unsigned long long)(reference_cnt + 1));
+        int whole = reference_cnt + (int)(xorshift64(&rng_state) % 3); //at least the whole string
+        int last_use[TEST_TABLE_MAX];
+        int window_faults = 0;
+        int seen[TEST_TABLE_MAX] = { 0 };
+        int distinct = 0;
+        int page_faults;
+        int longer;
+        double lower_rate = (double)(xorshift64(&rng_state) % 100) / 200.0;
+        double upper_rate = lower_rate + (double)(xorshift64(&rng_state) % 100) / 200.0;
+
+        for(int i = 0; i < table_cnt; i++){
+            last_use[i] = -window - 1; //never referenced, so out of every window
+        }
+        for(int i = 0; i < reference_cnt; i++){
+            distinct += seen[reference_string[i]] == 0;
+            seen[reference_string[i]] = 1;
+            window_faults += last_use[reference_string[i]] < i - window; //left the window before reference i
+            last_use[reference_string[i]] = i;
+        }
+        clear_table(page_table, table_cnt, frame_pool, table_cnt);
+        page_faults = count_page_faults_ws(page_table, table_cnt, reference_string, reference_cnt, frame_pool, table_cnt,
+            MAX(whole, 1), phase_length, phase_faults, &stats);
+        if(page_faults != distinct || stats.releases != 0 || stats.max_resident != distinct){
+            fail("whole-string window faults of", "ws", round, distinct, page_faults);
+        }
+        resident_consistent("ws", round, page_table, table_cnt, page_faults, phase_faults, &stats);
+
+        clear_table(page_table, table_cnt, frame_pool, table_cnt);
+        page_faults = count_page_faults_ws(page_table, table_cnt, reference_string, reference_cnt, frame_pool, table_cnt, window,
+            phase_length, phase_faults, &stats);
+        resident_consistent("ws", round, page_table, table_cnt, page_faults, phase_faults, &stats);
+        if(page_faults != window_faults || stats.replacements != 0 || stats.max_resident > window){
+            fail("window faults of", "ws", round, window_faults, page_faults);
+        }
+        clear_table(page_table, table_cnt, frame_pool, table_cnt);
+        longer = count_page_faults_ws(page_table, table_cnt, reference_string, reference_cnt, frame_pool, table_cnt,
+            window + 1 + (int)(xorshift64(&rng_state) % 8), phase_length, phase_faults, &stats);
+        if(longer > page_faults || longer < distinct){
+            fail("longer window faults of", "ws", round, page_faults, longer);
+        }
+
+        clear_table(page_table, table_cnt, frame_pool, table_cnt);
+        page_faults = count_page_faults_pff(page_table, table_cnt, reference_string, reference_cnt, frame_pool, table_cnt, 0.0, 0.0,
+            phase_length, phase_faults, &stats);
+        if(page_faults != distinct || stats.replacements != 0 || stats.releases != 0){
+            fail("growing faults of", "pff", round, distinct, page_faults);
+        }
+        resident_consistent("pff", round, page_table, table_cnt, page_faults, phase_faults, &stats);
+
+        clear_table(page_table, table_cnt, frame_pool, table_cnt);
+        page_faults = count_page_faults_pff(page_table, table_cnt, reference_string, reference_cnt, frame_pool, table_cnt, lower_rate,
+            upper_rate, phase_length, phase_faults, &stats);
+        if(page_faults < distinct || stats.max_resident > table_cnt){
+            fail("faults of", "pff", round, distinct, page_faults);
+        }
+        resident_consistent("pff", round, page_table, table_cnt, page_faults, phase_faults, &stats);
+    }
+}
+
+static void check_shards(int rounds)
+{
+    /*At a rate of 1 every page is sampled, so the sample is the whole string renumbered and its estimate
+at every frame count must be exactly the faults of a full run, with no error.*/
+    static int reference_string[TEST_REFS_MAX];
+    static struct PTE page_table[TEST_TABLE_MAX];
+    static int frame_pool[TEST_TABLE_MAX];
+    int frame_cnts[4];
+    struct SHARDS_ESTIMATE estimates[4];
+
+    for(int round = 0; round < rounds; round++){
+        int table_cnt = 1 + (int)(xorshift64(&rng_state) % TEST_TABLE_MAX);
+        int reference_cnt = random_string(reference_string, table_cnt);
+        struct SHARDS_SAMPLE *s = shards_create(1.0);
+
+        if(s == NULL){
+            fail("sample of", "shards", round, 0, -1);
+            continue;
+        }
+        for(int i = 0; i < reference_cnt; i++){
+            if(shards_add(s, (1LL << 40) + reference_string[i] * 7919LL) != 1){
+                fail("sampled reference of", "shards", round, 1, 0);
+                break;
+            }
+        }
+        for(int i = 0; i < 4; i++){
+            frame_cnts[i] = 1 + (int)(xorshift64(&rng_state) % (unsigned long long)table_cnt);
+        }
+        for(int policy = 0; policy < (int)(sizeof(policy_counts) / sizeof(policy_counts[0])); policy++){
+            if(shards_curve(s, policy, frame_cnts, 4, estimates) != 0){
+                fail("curve of policy", "shards", round, policy, -1);
+                continue;
+            }
+            for(int i = 0; i < 4; i++){
+                int faults;
+
+                clear_table(page_table, table_cnt, frame_pool, frame_cnts[i]);
+                faults = policy_counts[policy](page_table, table_cnt, reference_string, reference_cnt, frame_pool, frame_cnts[i]);
+                if(estimates[i].sampled_faults != faults || estimates[i].page_faults != faults || estimates[i].error != 0.0
+                    || estimates[i].sampled_references != reference_cnt){
+                    fail("full-rate faults of policy", "shards", round, faults, estimates[i].sampled_faults);
+                }
+            }
+        }
+        shards_destroy(s);
+    }
+}
+
+static void check_prefetch(int rounds)
+{
+    /*The frame a prefetching access returns must hold the page, even when the readahead of a prefetch
+hit needs more frames than there are, as it does with 2 frames, a depth of 2 and pages 0 then 2. Every
+prefetched page must end up referenced, wasted or still pending, and the context must count demand
+faults only.*/
+    static int reference_string[TEST_REFS_MAX];
+    static const char *const prefetch_names[] = { "none", "next", "stride", "adaptive" };
+    int fixed[2] = { 0, 2 };
+
+    for(int policy = 0; policy < (int)(sizeof(policy_counts) / sizeof(policy_counts[0])); policy++){
+        struct PAGE_CONTEXT *ctx = page_context_create(10, 2, policy);
+        struct PREFETCHER *pf = prefetcher_create(10, PREFETCH_NEXT_N, 2);
+
+        for(int i = 0; ctx != NULL && pf != NULL && i < 2; i++){
+            int frame_number = page_context_access_prefetch(pf, ctx, fixed[i], i + 1);
+
+            if(frame_number == -1 || ctx->page_table[fixed[i]].is_valid == 0 || ctx->page_table[fixed[i]].frame_number != frame_number){
+                fail("readahead frame of page", "prefetch", policy, fixed[i], frame_number);
+            }
+        }
+        if(ctx == NULL || pf == NULL){
+            fail("prefetcher of", "prefetch", policy, 0, -1);
+        }
+        page_context_destroy(ctx);
+        prefetcher_destroy(pf);
+    }
+    for(int round = 0; round < rounds; round++){
+        int table_cnt = 1 + (int)(xorshift64(&rng_state) % TEST_TABLE_MAX);
+        int frame_cnt = 1 + (int)(xorshift64(&rng_state) % (unsigned long long)table_cnt);
+        int prefetch_policy = 1 + (int)(xorshift64(&rng_state) % 3);
+        int depth = 1 + (int)(xorshift64(&rng_state) % 8);
+        int reference_cnt = random_string(reference_string, table_cnt);
+
+        for(int i = 0; i < reference_cnt; i++){
+            if(xorshift64(&rng_state) % 2 == 0 && i > 0){
+                reference_string[i] = (reference_string[i - 1] + 1) % table_cnt; //runs for the readahead to follow
+            }
+        }
+        for(int policy = 0; policy < (int)(sizeof(policy_counts) / sizeof(policy_counts[0])); policy++){
+            struct PAGE_CONTEXT *ctx = page_context_create(table_cnt, frame_cnt, policy);
+            struct PREFETCHER *pf = prefetcher_create(table_cnt, prefetch_policy, depth);
+
+            if(ctx == NULL || pf == NULL){
+                fail("prefetcher of", prefetch_names[prefetch_policy], round, 0, -1);
+                page_context_destroy(ctx);
+                prefetcher_destroy(pf);
+                continue;
+            }
+            for(int i = 0; i < reference_cnt; i++){
+                int page_number = reference_string[i];
+                int frame_number = page_context_access_prefetch(pf, ctx, page_number, i + 1);
+
+                if(frame_number == -1 || ctx->page_table[page_number].is_valid == 0
+                    || ctx->page_table[page_number].frame_number != frame_number){
+                    fail("readahead frame of", prefetch_names[prefetch_policy], round, frame_number, ctx->page_table[page_number].frame_number);
+                    break;
+                }
+            }
+            if(pf->prefetches != pf->prefetch_hits + pf->wasted_prefetches + pf->pending_cnt){
+                fail("prefetches of", prefetch_names[prefetch_policy], round, pf->prefetches,
+                    pf->prefetch_hits + pf->wasted_prefetches + pf->pending_cnt);
+            }
+            if(pf->demand_faults != ctx->page_faults){
+                fail("demand faults of", prefetch_names[prefetch_policy], round, pf->demand_faults, ctx->page_faults);
+            }
+            page_context_destroy(ctx);
+            prefetcher_destroy(pf);
+        }
+    }
+}
+
+static const struct TEST_CHECK checks[] = {
+    { "fixed", check_fixed },
+    { "engines", check_engines },
+    { "context", check_context },
+    { "trace", check_trace },
+    { "curve", check_curve },
+    { "sweep", check_sweep },
+    { "ghost", check_ghost },
+    { "opt", check_opt },
+    { "soa", check_soa },
+    { "manager", check_manager },
+    { "tlb", check_tlb },
+    { "sparse", check_sparse },
+    { "allocator", check_allocator },
+    { "disk", check_disk },
+    { "cpu", check_cpu },
+    { "workset", check_workset },
+    { "shards", check_shards },
+    { "prefetch", check_prefetch },
+};
+
+int main(int argc, char *argv[])
+{
+    const char *only = NULL;
+    int rounds = 300;
+    int ran = 0;
+
+    for(int i = 1; i < argc; i++){
+        if(strcmp(argv[i], "--check") == 0 && i + 1 < argc){
+            only = argv[++i];
+        }
+        else if(strcmp(argv[i], "--seed") == 0 && i + 1 < argc){
+            rng_state = strtoull(argv[++i], NULL, 10) | 1;
+        }
+        else if(strcmp(argv[i], "--rounds") == 0 && i + 1 < argc){
+            rounds = atoi(argv[++i]);
+        }
+        else {
+            fprintf(stderr, "usage: %s [--check NAME] [--seed N] [--rounds N]\n", argv[0]);
+            return 2;
+        }
+    }
+    for(size_t c = 0; c < sizeof(checks) / sizeof(checks[0]); c++){
+        if(only == NULL || strcmp(only, checks[c].name) == 0){
+            checks[c].run(rounds);
+            ran += 1;
+        }
+    }
+    if(ran == 0){
+        fprintf(stderr, "no check named %s\n", only);
+        return 2;
+    }
+    if(failures > 0){
+        fprintf(stderr, "%d checks failed\n", failures);
+        return 1;
+    }
+    printf("all checks passed\n");
+    return 0;
+}
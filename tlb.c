@@ -0,0 +1,225 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <limits.h>
+#include "oslabs.h"
+
+/*A TLB caches page-to-frame translations in front of the page table. It has entry_cnt entries split
+into sets of ways entries, and page p can only sit in set p % set_cnt, so a lookup compares at most
+ways entries. One set makes it fully associative, and one way per set makes it direct mapped. A full
+set replaces its least recently used entry, its oldest fill or a random entry.
+
+The page replacement policy still sees every access, TLB hit or not, the way the hardware sets the
+referenced bit on a hit, so the page faults of a run are the same with and without a TLB. When a page
+leaves memory its entry is shot down. An entry can still go stale when the page table changes behind
+the TLB, as on a page_context_reset, so an entry is checked against the page table before it counts as
+a hit and is shot down if its page is no longer in that frame. A TLB hit is always a page in memory.*/
+
+static int valid_tlb_policy(int policy)
+{
+    return policy == TLB_REPLACE_LRU || policy == TLB_REPLACE_FIFO || policy == TLB_REPLACE_RANDOM;
+}
+
+static int tlb_find(struct TLB *tlb, int page_number)
+{
+    //entry holding the page, -1 if none
+    int first = page_number % tlb->set_cnt * tlb->ways;
+
+    for(int i = first; i < first + tlb->ways; i++){
+        if(tlb->page_number[i] == page_number){
+            return i;
+        }
+    }
+    return -1;
+}
+
+static int tlb_victim(struct TLB *tlb, int page_number)
+{
+    //entry the page goes into: an empty way of its set if there is one, otherwise the policy's choice
+    int first = page_number % tlb->set_cnt * tlb->ways;
+    int victim = first;
+
+    for(int i = first; i < first + tlb->ways; i++){
+        if(tlb->page_number[i] == -1){
+            return i;
+        }
+        if(tlb->stamp[i] < tlb->stamp[victim]){
+            victim = i;
+        }
+    }
+    if(tlb->policy == TLB_REPLACE_RANDOM){
+        victim = first + (int)(xorshift64(&tlb->rng_state) % (unsigned long long)tlb->ways);
+    }
+    return victim;
+}
+
+struct TLB *tlb_create(int entry_cnt, int ways, int policy)
+{
+    /*Creates an empty TLB of entry_cnt entries in sets of ways entries, replacing entries by policy, one
+of the TLB_REPLACE_ values. Returns NULL if entry_cnt is not a positive multiple of ways, the policy
+is unknown or the arena cannot be allocated.*/
+    struct ARENA arena;
+    struct TLB *tlb;
+
+    if(entry_cnt <= 0 || ways <= 0 || entry_cnt % ways != 0 || !valid_tlb_policy(policy)){
+        return NULL;
+    }
+    arena.base = malloc(arena_size(sizeof(struct TLB)) + 2 * arena_size((size_t)entry_cnt * sizeof(int))
+        + arena_size((size_t)entry_cnt * sizeof(long long)));
+    arena.used = 0;
+    if(arena.base == NULL){
+        return NULL;
+    }
+    tlb = arena_take(&arena, sizeof(struct TLB));
+    tlb->arena = arena.base;
+    tlb->entry_cnt = entry_cnt;
+    tlb->ways = ways;
+    tlb->set_cnt = entry_cnt / ways;
+    tlb->policy = policy;
+    tlb->page_number = arena_take(&arena, (size_t)entry_cnt * sizeof(int));
+    tlb->frame_number = arena_take(&arena, (size_t)entry_cnt * sizeof(int));
+    tlb->stamp = arena_take(&arena, (size_t)entry_cnt * sizeof(long long));
+    tlb_reset(tlb);
+    return tlb;
+}
+
+void tlb_destroy(struct TLB *tlb)
+{
+    if(tlb != NULL){
+        free(tlb->arena); //the TLB itself lives in the arena
+    }
+}
+
+void tlb_flush(struct TLB *tlb)
+{
+    //empties every entry, as on a switch to another address space, and keeps the counters
+    for(int i = 0; i < tlb->entry_cnt; i++){
+        tlb->page_number[i] = -1;
+        tlb->frame_number[i] = -1;
+        tlb->stamp[i] = 0;
+    }
+}
+
+void tlb_reset(struct TLB *tlb)
+{
+    //empties every entry and starts the counters and the random sequence over
+    tlb_flush(tlb);
+    tlb->tick = 0;
+    tlb->rng_state = XORSHIFT64_SEED;
+    tlb->hits = 0;
+    tlb->misses = 0;
+    tlb->shootdowns = 0;
+}
+
+int tlb_lookup(struct TLB *tlb, int page_number)
+{
+    /*Returns the frame number the TLB holds for the page and counts a hit, or returns -1 and counts a
+miss. A hit makes the entry the most recently used of its set.*/
+    int entry = page_number < 0 ? -1 : tlb_find(tlb, page_number);
+
+    if(entry == -1){
+        tlb->misses += 1;
+        return -1;
+    }
+    tlb->hits += 1;
+    if(tlb->policy == TLB_REPLACE_LRU){
+        tlb->stamp[entry] = ++tlb->tick;
+    }
+    return tlb->frame_number[entry];
+}
+
+void tlb_insert(struct TLB *tlb, int page_number, int frame_number)
+{
+    //caches the translation, replacing an entry of the page's set if the set is full
+    int entry = tlb_find(tlb, page_number);
+
+    if(entry == -1){
+        entry = tlb_victim(tlb, page_number);
+    }
+    tlb->page_number[entry] = page_number;
+    tlb->frame_number[entry] = frame_number;
+    tlb->stamp[entry] = ++tlb->tick;
+}
+
+int tlb_shootdown(struct TLB *tlb, int page_number)
+{
+    //drops the page's entry, returning 1 if it had one and 0 if not
+    int entry = tlb_find(tlb, page_number);
+
+    if(entry == -1){
+        return 0;
+    }
+    tlb->page_number[entry] = -1;
+    tlb->frame_number[entry] = -1;
+    tlb->stamp[entry] = 0;
+    tlb->shootdowns += 1;
+    return 1;
+}
+
+int page_context_access_tlb(struct TLB *tlb, struct PAGE_CONTEXT *ctx, int page_number, int current_timestamp)
+{
+    /*Same as page_context_access with the TLB looked up first. An entry that no longer matches the page
+table is shot down and the lookup misses. On a miss the translation is cached after the access, and
+the page the access moved out of memory, if any, is shot down first. Returns -1 under the same
+conditions as page_context_access.*/
+    struct PTE *entry;
+    int cached;
+    int frame_number;
+
+    if(page_number < 0 || page_number >= ctx->table_cnt){
+        return -1;
+    }
+    entry = &ctx->page_table[page_number];
+    cached = tlb_find(tlb, page_number);
+    if(cached != -1 && (entry->is_valid == 0 || entry->frame_number != tlb->frame_number[cached])){
+        tlb_shootdown(tlb, page_number); //stale, so the lookup below misses
+    }
+    cached = tlb_lookup(tlb, page_number);
+    frame_number = page_context_access(ctx, page_number, current_timestamp); //the policy sees hits too
+    if(frame_number == -1 || cached != -1){
+        return frame_number; //a checked hit is a page in memory, so nothing moved out
+    }
+    if(ctx->evicted_page != -1){
+        tlb_shootdown(tlb, ctx->evicted_page);
+    }
+    tlb_insert(tlb, page_number, frame_number);
+    return frame_number;
+}
+
+int process_page_access_tlb(struct TLB *tlb,
+int policy,
+struct PTE page_table[],
+int *table_cnt,
+int page_number,
+int frame_pool[],
+int *frame_cnt,
+int current_timestamp)
+{
+    /*Same as process_page_access_fifo, _lru, _lfu or _clock, picked by policy, with the TLB looked up
+first and a replaced page shot down. The TLB must only ever be used with this page table.*/
+    struct PAGE_CONTEXT view;
+    int frame_number;
+
+    page_context_view(&view, page_table, *table_cnt, frame_pool, *frame_cnt, policy);
+    frame_number = page_context_access_tlb(tlb, &view, page_number, current_timestamp);
+    *frame_cnt = view.frame_cnt; //a frame may have been taken from the pool
+    return frame_number;
+}
+
+int page_context_run_tlb(struct TLB *tlb, struct PAGE_CONTEXT *ctx, int reference_string[], int reference_cnt, long long *tlb_misses)
+{
+    /*Same as page_context_run through the TLB. Returns the number of page faults in this run, or -1 if
+an access fails or the timestamp reaches INT_MAX, and stores the number of TLB misses in this run in *tlb_misses unless it is NULL.*/
+    long long page_faults = ctx->page_faults;
+    long long misses = tlb->misses;
+
+    for(int i = 0; i < reference_cnt; i++){
+        if(ctx->timestamp == INT_MAX || page_context_access_tlb(tlb, ctx, reference_string[i], ctx->timestamp) == -1){
+            return -1;
+        }
+        ctx->timestamp += 1;
+    }
+    if(tlb_misses != NULL){
+        *tlb_misses = tlb->misses - misses;
+    }
+    return (int)(ctx->page_faults - page_faults);
+}
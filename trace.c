@@ -0,0 +1,234 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <limits.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "oslabs.h"
+
+/*A TRACE_READER hands out the page numbers of a reference trace one at a time, so a fault count can be
+taken over a trace of any length without holding it in memory. A trace opened by path is mapped and
+read in place. Anything else, like a pipe or standard input, is read through the reader's fixed
+TRACE_CHUNK buffer. Either way memory use does not depend on the length of the trace, but the
+timestamps of a PAGE_CONTEXT are int, so one context takes at most INT_MAX - 1 references between
+resets. That is about 2.1 * 10^9, an 8 GB TRACE_U32 trace, and the run functions fail past it rather
+than let the timestamps wrap.*/
+
+static int valid_format(int format)
+{
+    return format == TRACE_U32 || format == TRACE_U64 || format == TRACE_TEXT || format == TRACE_VARINT;
+}
+
+int trace_open(struct TRACE_READER *trace, const char *path, int format)
+{
+    /*Opens a trace file, mapping it when it is a regular file. Returns 0 on success and -1 if the
+format is unknown or the file cannot be opened.*/
+    struct stat info;
+    int fd;
+
+    if(!valid_format(format)){
+        return -1;
+    }
+    fd = open(path, O_RDONLY);
+    if(fd == -1){
+        return -1;
+    }
+    trace_open_fd(trace, fd, format);
+    trace->owns_fd = 1;
+    if(fstat(fd, &info) == 0 && S_ISREG(info.st_mode) && info.st_size > 0){
+        void *map = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if(map != MAP_FAILED){
+            madvise(map, (size_t)info.st_size, MADV_SEQUENTIAL); //let the kernel read ahead and drop pages behind us
+            trace->map = map;
+            trace->map_size = info.st_size;
+        }
+    }
+    return 0;
+}
+
+int trace_open_fd(struct TRACE_READER *trace, int fd, int format)
+{
+    /*Reads a trace from a descriptor the caller owns, in TRACE_CHUNK pieces. Returns 0 on success and
+-1 if the format is unknown.*/
+    if(!valid_format(format)){
+        return -1;
+    }
+    trace->format = format;
+    trace->fd = fd;
+    trace->owns_fd = 0;
+    trace->map = NULL;
+    trace->map_size = 0;
+    trace->offset = 0;
+    trace->chunk_len = 0;
+    trace->chunk_pos = 0;
+    trace->references = 0;
+    return 0;
+}
+
+void trace_close(struct TRACE_READER *trace)
+{
+    if(trace->map != NULL){
+        munmap((void *)trace->map, (size_t)trace->map_size);
+        trace->map = NULL;
+    }
+    if(trace->owns_fd){
+        close(trace->fd);
+        trace->owns_fd = 0;
+    }
+}
+
+static int trace_byte(struct TRACE_READER *trace)
+{
+    //next byte of the trace, -1 at the end and -2 on a read error
+    if(trace->map != NULL){
+        if(trace->offset >= trace->map_size){
+            return -1;
+        }
+        return trace->map[trace->offset++];
+    }
+    if(trace->chunk_pos == trace->chunk_len){
+        ssize_t got;
+
+        do {
+            got = read(trace->fd, trace->chunk, TRACE_CHUNK);
+        } while(got == -1 && errno == EINTR);
+        if(got <= 0){
+            return got == 0 ? -1 : -2;
+        }
+        trace->chunk_len = (int)got;
+        trace->chunk_pos = 0;
+    }
+    return trace->chunk[trace->chunk_pos++];
+}
+
+static int trace_fixed(struct TRACE_READER *trace, int width, long long *page_number)
+{
+    //reads one packed little-endian number of width bytes
+    unsigned long long value = 0;
+
+    if(trace->map != NULL){
+        if(trace->map_size - trace->offset < width){
+            return 0; //a partial number at the end of the file is ignored
+        }
+        for(int i = 0; i < width; i++){
+            value |= (unsigned long long)trace->map[trace->offset + i] << (8 * i);
+        }
+        trace->offset += width;
+    }
+    else {
+        for(int i = 0; i < width; i++){
+            int byte = trace_byte(trace);
+            if(byte < 0){
+                return byte == -1 ? 0 : -1;
+            }
+            value |= (unsigned long long)byte << (8 * i);
+        }
+    }
+    *page_number = (long long)value;
+    return 1;
+}
+
+static int trace_text(struct TRACE_READER *trace, long long *page_number)
+{
+    //reads one decimal number, a negative one or one past LLONG_MAX is malformed
+    long long value = 0;
+    int before = -1;
+    int byte = -1;
+
+    do {
+        before = byte;
+        byte = trace_byte(trace);
+    } while(byte >= 0 && (byte < '0' || byte > '9')); //skips separators
+    if(byte < 0){
+        return byte == -1 ? 0 : -1;
+    }
+    if(before == '-'){
+        return -1;
+    }
+    while(byte >= '0' && byte <= '9'){
+        if(value > (LLONG_MAX - (byte - '0')) / 10){
+            return -1;
+        }
+        value = value * 10 + (byte - '0');
+        byte = trace_byte(trace);
+    }
+    if(byte == -2){
+        return -1;
+    }
+    *page_number = value;
+    return 1;
+}
+
+static int trace_varint(struct TRACE_READER *trace, long long *page_number)
+{
+    unsigned long long value = 0;
+    int shift = 0;
+    int byte;
+
+    do {
+        byte = trace_byte(trace);
+        if(byte < 0){
+            return byte == -1 && shift == 0 ? 0 : -1; //end of trace in the middle of a number is an error
+        }
+        if(shift > 63){
+            return -1;
+        }
+        value |= (unsigned long long)(byte & 0x7f) << shift;
+        shift += 7;
+    } while(byte & 0x80);
+    *page_number = (long long)value;
+    return 1;
+}
+
+int trace_next(struct TRACE_READER *trace, long long *page_number)
+{
+    /*Stores the next page number of the trace in page_number. Returns 1 when a page number was read, 0
+at the end of the trace and -1 on a read error, a malformed varint or a malformed decimal number.*/
+    int got;
+
+    switch(trace->format){
+    case TRACE_U32:
+        got = trace_fixed(trace, 4, page_number);
+        break;
+    case TRACE_U64:
+        got = trace_fixed(trace, 8, page_number);
+        break;
+    case TRACE_TEXT:
+        got = trace_text(trace, page_number);
+        break;
+    default:
+        got = trace_varint(trace, page_number);
+        break;
+    }
+    if(got == 1){
+        trace->references += 1;
+    }
+    return got;
+}
+
+long long count_page_faults_trace(struct PAGE_CONTEXT *ctx, struct TRACE_READER *trace)
+{
+    /*Runs every page number of the trace through the context, giving each access the context's next
+timestamp, just like page_context_run does for a reference string. Returns the number of page faults
+in this run, or -1 if the trace cannot be read, names a page outside the page table or is longer than
+the context's timestamps can count (INT_MAX - 1 references since the context was reset).*/
+    long long page_faults = ctx->page_faults;
+    long long page_number;
+    int got;
+
+    while((got = trace_next(trace, &page_number)) == 1){
+        if(page_number < 0 || page_number >= ctx->table_cnt || ctx->timestamp == INT_MAX){
+            return -1;
+        }
+        if(page_context_access(ctx, (int)page_number, ctx->timestamp) == -1){
+            return -1;
+        }
+        ctx->timestamp += 1;
+    }
+    if(got == -1){
+        return -1;
+    }
+    return ctx->page_faults - page_faults;
+}
@@ -1,473 +1,438 @@
 #include <stdio.h>
+#include <stdlib.h>
 #include <limits.h>
 #include "oslabs.h"
 
-
-int process_page_access_fifo(struct PTE page_table[TABLEMAX],
-int *table_cnt, 
-int page_number, 
-int frame_pool[POOLMAX],
+/*The page replacement functions below keep their original signatures but are thin wrappers over a
+PAGE_CONTEXT (context.c), which holds the page-table rules for all policies. A single
+process_page_access_* call only looks at the caller's arrays in place, so it finds the page to replace
+by scanning the page table exactly as before. A count_page_faults_* call covers a whole reference
+string, so it attaches a context whose replacement engine finds each victim without a scan: in
+constant time for FIFO and LRU and in O(log n) for LFU. CLOCK is amortized O(log n): each second
+chance is paid for by the hit that set the bit, but the pages one fault moves to the tail are merge
+sorted by page number to keep the scan's tie-break.*/
+
+static int process_page_access(int policy,
+struct PTE page_table[],
+int *table_cnt,
+int page_number,
+int frame_pool[],
 int *frame_cnt,
 int current_timestamp)
 {
-    /*First the function checks if the page being referenced is already in memory (i.e., the page-table
-entry has the valid bit true). If so, it returns the frame number, after modifying the
-last_access_timestamp and the reference_count fields of the page-table entry.*/
-
-    if (page_table[page_number].is_valid !=0 ){
-       page_table[page_number].reference_count += 1; //update reference count
-       page_table[page_number].last_access_timestamp = current_timestamp; //update time
-       return page_table[page_number].frame_number;
-    }
-    /*If the page being referenced is not in memory, the function checks if there are any free frames
-(i.e., the process frame pool is not empty). If so, a frame is removed from the process frame
-pool and the frame number is inserted into the page-table entry corresponding to the logical
-page number. In addition, the other fields of the page-table entry are set appropriately. The
-function returns the frame number associated with the page-table entry.
-*/
-    else if(page_table[page_number].is_valid == 0 && *frame_cnt > 0){
-        *frame_cnt -= 1; //lowers frame count
-        page_table[page_number].frame_number = frame_pool[*frame_cnt];//updates the number of free frames
-        page_table[page_number].reference_count = 1; //update reference count
-        page_table[page_number].last_access_timestamp = current_timestamp; //update time
-        page_table[page_number].is_valid = 1; //moved to memory so it is valid
-        page_table[page_number].arrival_timestamp = current_timestamp;//updates arrival time
-        return page_table[page_number].frame_number;
-    }
+    struct PAGE_CONTEXT view;
+    int frame_number;
 
-    /*If the page being referenced is not in memory and there are no free frames for the process, a
-page needs to be replaced. The function selects among all the pages of the process that are
-currently in memory (i.e., they have valid bits as true) the page that has the smallest
-arrival_timestamp. It marks that page_table entry as invalid, along with setting the
-frame_number, arrival_timestamp, last_access_timestamp and reference_count to -1. It then
-sets the frame_number of the page-table entry of the newly-referenced page to the newly freed
-frame. It also sets the arrival_timestamp, the last_access_timestamp and the reference_count
-fields of the page-table entry appropriately. Finally, the function returns this frame number.
-*/
-    else {
-        int earliest_access_timestamp = INT_MAX;
-        int earliest_loc = 0;
-
-        for(int i = 0; i < *table_cnt; i++){
-            if(page_table[i].is_valid != 0){ //checks if the page is in memory 
-                 if(page_table[i].arrival_timestamp < earliest_access_timestamp){ //checks if the arrival timestamp is lower than the last
-                    earliest_access_timestamp = page_table[i].arrival_timestamp;//the arrival timestamp is updated 
-                    earliest_loc = i;//the earliest arrival location is saved
-                 }
-            }
-        }
-        page_table[page_number].frame_number = page_table[earliest_loc].frame_number; //replaces the page in memory
-        page_table[page_number].is_valid = 1; //sets it to valid so the fact its in memory is marked
-        page_table[page_number].arrival_timestamp = current_timestamp;//updates arrival time
-        page_table[page_number].last_access_timestamp = current_timestamp;//updates  last access time
-        page_table[page_number].reference_count = 1;//this is the first time it was referenced the count is 1
-        
-        //Move to the page no longer in memory all values are set to null since it is no longer in memory
-
-        page_table[earliest_loc].frame_number = -1;
-        page_table[earliest_loc].is_valid = 0;
-        page_table[earliest_loc].arrival_timestamp = -1;
-        page_table[earliest_loc].last_access_timestamp = -1;
-        page_table[earliest_loc].reference_count = -1;
-        return page_table[page_number].frame_number;
-    }    
-    
+    page_context_view(&view, page_table, *table_cnt, frame_pool, *frame_cnt, policy);
+    frame_number = page_context_access(&view, page_number, current_timestamp);
+    *frame_cnt = view.frame_cnt; //a frame may have been taken from the pool
+    return frame_number;
 }
-int count_page_faults_fifo(struct PTE page_table[TABLEMAX],
+
+static int count_page_faults(int policy,
+struct PTE page_table[],
 int table_cnt,
-int reference_string[REFERENCEMAX],
+int reference_string[],
 int reference_cnt,
-int frame_pool[POOLMAX],
+int frame_pool[],
 int frame_cnt)
 {
-    /*When simulating the processing of a page access, the function first checks if the page being
-referenced is already in memory (i.e., the page-table entry has the valid bit true). If so, it
-modifies the last_access_timestamp and the reference_count fields of the page-table entry. It
-then moves on to the processing of the next entry in the sequence of logical page numbers.*/
-    int page_fault_counter = 0;
-    int timestamp = 1;
-    for(int i = 0; i < reference_cnt; i++){
-        if (page_table[reference_string[i]].is_valid !=0 ){
-         page_table[reference_string[i]].reference_count += 1; //update reference count
-         page_table[reference_string[i]].last_access_timestamp = timestamp; //update time
-        }
+    struct PAGE_CONTEXT *ctx = page_context_attach(page_table, table_cnt, frame_pool, frame_cnt, policy);
+    int page_fault_counter;
 
-     
-   /*In order to simulate timestamps, the function starts with a timestamp of 1 and increments it
-whenever the processing of a new page access is begun.
-
-If the page being referenced is not in memory, the function checks if there are any free frames
-(i.e., the process frame pool is not empty). If so, a frame is removed from the process frame
-pool and the frame number is inserted into the page-table entry corresponding to the logical
-page number. In addition, the other fields of the page-table entry are set appropriately. The
-function counts this page access as a page fault.*/
-        else if (page_table[reference_string[i]].is_valid == 0 && frame_cnt > 0){
-            frame_cnt -= 1;
-            page_table[reference_string[i]].frame_number = frame_pool[frame_cnt];//updates the number of free frames
-            page_table[reference_string[i]].last_access_timestamp = timestamp; //update time
-            page_table[reference_string[i]].arrival_timestamp = timestamp; //update time
-            page_table[reference_string[i]].reference_count = 1; //update reference count
-            page_table[reference_string[i]].is_valid = 1; //moved to memory so it is valid
-            page_fault_counter++;
-            timestamp++;
-        }
-    
-/*If the page being referenced is not in memory and there are no free frames for the process, a
-page needs to be replaced. The function selects among all the pages of the process that are
-currently in memory (i.e., they have valid bits as true) the page that has the smallest
-arrival_timestamp. It marks that page-table entry as invalid, along with setting the
-arrival_timestamp, last_access_timestamp and reference_count to -1. It then sets the
-frame_number of the page-table entry of the newly-referenced page to the newly freed frame. It
-also sets the arrival_timestamp, the last_access_timestamp and the reference_count fields of
-the page-table entry appropriately. The function counts this page access as a page fault.
-The function returns the total number of page faults encountered in the simulation.*/
-        else {
-        int earliest_access_timestamp = INT_MAX;
-        int earliest_loc = 0;
-
-        for(int x = 0; x < table_cnt; x++){
-            if(page_table[x].is_valid != 0){ //checks if the page is in memory 
-                 if(page_table[x].arrival_timestamp < earliest_access_timestamp){ //checks if the arrival timestamp is lower than the last
-                    earliest_access_timestamp = page_table[x].arrival_timestamp;//the arrival timestamp is updated 
-                    earliest_loc = i;//the earliest arrival location is saved
-                 }
-            }
-        }
-        page_table[reference_string[i]].frame_number = page_table[earliest_loc].frame_number; //replaces the page in memory
-        page_table[reference_string[i]].is_valid = 1; //sets it to valid so the fact its in memory is marked
-        page_table[reference_string[i]].arrival_timestamp = timestamp;//updates arrival time
-        page_table[reference_string[i]].last_access_timestamp = timestamp;//updates  last access time
-        page_table[reference_string[i]].reference_count = 1;//this is the first time it was referenced the count is 1
-        
-        //Move to the page no longer in memory all values are set to null since it is no longer in memory
-
-        page_table[earliest_loc].frame_number = -1;
-        page_table[earliest_loc].is_valid = 0;
-        page_table[earliest_loc].arrival_timestamp = -1;
-        page_table[earliest_loc].last_access_timestamp = -1;
-        page_table[earliest_loc].reference_count = -1;
-
-        page_fault_counter++;
-        timestamp++;
-        
-        }
+    if(ctx == NULL){
+        return -1;
     }
+    page_fault_counter = page_context_run(ctx, reference_string, reference_cnt);
+    page_context_destroy(ctx);
     return page_fault_counter;
 }
-int process_page_access_lfu(struct PTE page_table[TABLEMAX],
+
+int process_page_access_fifo(struct PTE page_table[],
+int *table_cnt, 
+int page_number, 
+int frame_pool[],
+int *frame_cnt,
+int current_timestamp)
+{
+    /*Returns the frame number of the logical page, loading it if needed. When there are no free frames
+the page with the smallest arrival_timestamp is replaced.*/
+    return process_page_access(POLICY_FIFO, page_table, table_cnt, page_number, frame_pool, frame_cnt, current_timestamp);
+}
+int count_page_faults_fifo(struct PTE page_table[],
+int table_cnt,
+int reference_string[],
+int reference_cnt,
+int frame_pool[],
+int frame_cnt)
+{
+    /*Returns the number of page faults for the reference string under FIFO replacement, starting with
+a timestamp of 1 and incrementing it for every page access. Returns -1 if the context cannot be
+allocated or the reference string names a page outside the page table.*/
+    return count_page_faults(POLICY_FIFO, page_table, table_cnt, reference_string, reference_cnt, frame_pool, frame_cnt);
+}
+int process_page_access_lfu(struct PTE page_table[],
 int *table_cnt, 
 int page_number, 
-int frame_pool[POOLMAX],
+int frame_pool[],
 int *frame_cnt, 
 int current_timestamp
 )
 {
-    if (page_table[page_number].is_valid !=0 ){
-       page_table[page_number].reference_count += 1; //update reference count
-       page_table[page_number].last_access_timestamp = current_timestamp; //update time
-       return page_table[page_number].frame_number;
-    }
-    /*If the page being referenced is not in memory, the function checks if there are any free frames
-(i.e., the process frame pool is not empty). If so, a frame is removed from the process frame
-pool and the frame number is inserted into the page-table entry corresponding to the logical
-page number. In addition, the other fields of the page-table entry are set appropriately. The
-function returns the frame number associated with the page-table entry.
-*/
-    else if(page_table[page_number].is_valid == 0 && *frame_cnt > 0){
-        *frame_cnt -= 1; //lowers frame count
-        page_table[page_number].frame_number = frame_pool[*frame_cnt];//updates the number of free frames
-        page_table[page_number].reference_count = 1; //update reference count
-        page_table[page_number].last_access_timestamp = current_timestamp; //update time
-        page_table[page_number].is_valid = 1; //moved to memory so it is valid
-        page_table[page_number].arrival_timestamp = current_timestamp;//updates arrival time
-        return page_table[page_number].frame_number;
-    }
+    /*Returns the frame number of the logical page, loading it if needed. When there are no free frames
+the page with the smallest reference_count is replaced, the smallest arrival_timestamp breaking ties.*/
+    return process_page_access(POLICY_LFU, page_table, table_cnt, page_number, frame_pool, frame_cnt, current_timestamp);
+}
+int count_page_faults_lfu(struct PTE page_table[],
+int table_cnt,
+int refrence_string[],
+int reference_cnt,
+int frame_pool[],
+int frame_cnt)
+{
+    /*Returns the number of page faults for the reference string under LFU replacement, starting with
+a timestamp of 1 and incrementing it for every page access. Returns -1 if the context cannot be
+allocated or the reference string names a page outside the page table.*/
+    return count_page_faults(POLICY_LFU, page_table, table_cnt, refrence_string, reference_cnt, frame_pool, frame_cnt);
+}
 
-    /*If the page being referenced is not in memory and there are no free frames for the process, a
-page needs to be replaced. The function selects among all the pages of the process that are
-currently in memory (i.e., they have valid bits as true) the page that has the smallest
-arrival_timestamp. It marks that page_table entry as invalid, along with setting the
-frame_number, arrival_timestamp, last_access_timestamp and reference_count to -1. It then
-sets the frame_number of the page-table entry of the newly-referenced page to the newly freed
-frame. It also sets the arrival_timestamp, the last_access_timestamp and the reference_count
-fields of the page-table entry appropriately. Finally, the function returns this frame number.
-*/
-    else {
-        int lowest_frq = INT_MAX;
-        int lowest_loc = 0;
-
-        for(int i = 0; i < *table_cnt; i++){
-
-            if(page_table[i].is_valid != 0){ //checks if the page is in memory 
-                 if (page_table[i].reference_count == page_table[lowest_loc].reference_count){ //if refrence counts are equal 
-                    if(page_table[i].arrival_timestamp < page_table[lowest_loc].arrival_timestamp){ //compares arrival timestamp
-                        lowest_loc = i;//moves lowest location to lower timestamp
-                 }
-                 else if (page_table[i].reference_count < page_table[lowest_loc].reference_count){ // compares the reference counts 
-                    lowest_frq = page_table[i].reference_count; //saves the lowest frequency
-                    lowest_loc = i; //saves the lowest location
-                 }
-            }
-        }
-        page_table[page_number].frame_number = page_table[lowest_loc].frame_number; //replaces the page in memory
-        page_table[page_number].is_valid = 1; //sets it to valid so the fact its in memory is marked
-        page_table[page_number].arrival_timestamp = current_timestamp;//updates arrival time
-        page_table[page_number].last_access_timestamp = current_timestamp;//updates  last access time
-        page_table[page_number].reference_count = 1;//this is the first time it was referenced the count is 1
-        
-        //Move to the page no longer in memory all values are set to null since it is no longer in memory
-
-        page_table[lowest_loc].frame_number = -1;
-        page_table[lowest_loc].is_valid = 0;
-        page_table[lowest_loc].arrival_timestamp = -1;
-        page_table[lowest_loc].last_access_timestamp = -1;
-        page_table[lowest_loc].reference_count = -1;
-        return page_table[page_number].frame_number;
-    }
-    }    
+int process_page_access_lru(struct PTE page_table[],
+int *table_cnt, 
+int page_number, 
+int frame_pool[],
+int *frame_cnt, 
+int current_timestamp)
+{
+    /*Returns the frame number of the logical page, loading it if needed. When there are no free frames
+the page with the smallest last_access_timestamp is replaced.*/
+    return process_page_access(POLICY_LRU, page_table, table_cnt, page_number, frame_pool, frame_cnt, current_timestamp);
 }
-int count_page_faults_lfu(struct PTE page_table[TABLEMAX],
+int count_page_faults_lru(struct PTE page_table[],
 int table_cnt,
-int refrence_string[REFERENCEMAX],
+int refrence_string[],
 int reference_cnt,
-int frame_pool[POOLMAX],
+int frame_pool[],
 int frame_cnt)
 {
-    /*The function returns the estimated number of page faults for the reference string, with respect to
-the pool of frames allocated to the process. For each logical page number (in the sequence),
-the function simulates the processing of the page access in the LRU system. It keeps track of
-the number of page faults that occur in the system as it simulates the processing of the entire
-sequence of logical page numbers.*/
-    int page_fault_counter = 0;
-    int timestamp = 1;
-/*When simulating the processing of a page access, the function first checks if the page being
-referenced is already in memory (i.e., the page-table entry has the valid bit true). If so, it
-modifies the last_access_timestamp and the reference_count fields of the page-table entry. It
-then moves on to the processing of the next entry in the sequence of logical page numbers.
-In order to simulate timestamps, the function starts with a timestamp of 1 and increments it
-whenever the processing of a new page access is begun.*/
-for(int i = 0; i < reference_cnt; i++){
-    if (page_table[refrence_string[i]].is_valid !=0 ){
-       page_table[refrence_string[i]].reference_count += 1; //update reference count
-       page_table[refrence_string[i]].last_access_timestamp = timestamp; //update time
+    /*Returns the number of page faults for the reference string under LRU replacement, starting with
+a timestamp of 1 and incrementing it for every page access. Returns -1 if the context cannot be
+allocated or the reference string names a page outside the page table.*/
+    return count_page_faults(POLICY_LRU, page_table, table_cnt, refrence_string, reference_cnt, frame_pool, frame_cnt);
+}
+
+static int compare_keys(const void *a, const void *b)
+{
+    long long x = *(const long long *)a;
+    long long y = *(const long long *)b;
+    return (x > y) - (x < y);
+}
+
+static int list_init(struct LRU_LIST *list,
+int prev[],
+int next[],
+struct PTE page_table[],
+int table_cnt,
+int by_arrival)
+{
+    /*Links every page that is already in memory (valid bit true) onto the list, oldest timestamp
+first. Pages with equal timestamps are ordered by page number, which is the order the linear scan
+in the process_page_access functions picks them in.*/
+    long long *keys = NULL;
+    int valid_cnt = 0;
+
+    list->prev = prev;
+    list->next = next;
+    list->head = -1;
+    list->tail = -1;
+    list->size = 0;
+    list->rank = NULL;
+    for(int i = 0; i < table_cnt; i++){
+        prev[i] = -1;
+        next[i] = -1;
+        if(page_table[i].is_valid != 0){
+            valid_cnt++;
+        }
+    }
+    if(valid_cnt == 0){
+        return 0;
+    }
+    keys = malloc((size_t)valid_cnt * sizeof(long long));
+    if(keys == NULL){
+        return -1;
     }
+    valid_cnt = 0;
+    for(int i = 0; i < table_cnt; i++){
+        if(page_table[i].is_valid != 0){
+            int timestamp = by_arrival ? page_table[i].arrival_timestamp : page_table[i].last_access_timestamp;
+            keys[valid_cnt++] = (long long)timestamp * 4294967296LL + i; //timestamp first, page number breaks ties
+        }
+    }
+    qsort(keys, valid_cnt, sizeof(long long), compare_keys);
+    for(int i = 0; i < valid_cnt; i++){
+        lru_list_push(list, (int)(keys[i] & 0xffffffffLL));
+    }
+    free(keys);
+    return 0;
+}
 
+int lru_list_init(struct LRU_LIST *list,
+int prev[],
+int next[],
+struct PTE page_table[],
+int table_cnt)
+{
+    /*Links the pages in memory in last_access_timestamp order. The prev and next arrays are owned by the
+caller and must hold table_cnt entries each.
+Returns 0 on success and -1 if the temporary sort buffer cannot be allocated.*/
+    return list_init(list, prev, next, page_table, table_cnt, 0);
+}
 
+int fifo_list_init(struct LRU_LIST *list,
+int prev[],
+int next[],
+struct PTE page_table[],
+int table_cnt)
+{
+    //same as lru_list_init but in arrival_timestamp order, which is the FIFO queue
+    return list_init(list, prev, next, page_table, table_cnt, 1);
+}
 
-/*If the page being referenced is not in memory, the function checks if there are any free frames
-(i.e., the process frame pool is not empty). If so, a frame is removed from the process frame
-pool and the frame number is inserted into the page-table entry corresponding to the logical
-page number. In addition, the other fields of the page-table entry are set appropriately. The
-function counts this page access as a page fault.*/
-    else if(page_table[refrence_string[i]].is_valid == 0 && frame_cnt > 0){
-        frame_cnt -= 1; //lowers frame count
-        page_table[refrence_string[i]].frame_number = frame_pool[frame_cnt];//updates the number of free frames
-        page_table[refrence_string[i]].reference_count = 1; //update reference count
-        page_table[refrence_string[i]].last_access_timestamp = timestamp; //update time
-        page_table[refrence_string[i]].is_valid = 1; //moved to memory so it is valid
-        page_table[refrence_string[i]].arrival_timestamp = timestamp;//updates arrival time
-        page_fault_counter += 1;
-        
+void lru_list_push(struct LRU_LIST *list, int page_number)
+{
+    //appends the page at the most recently used end
+    list->prev[page_number] = list->tail;
+    list->next[page_number] = -1;
+    if(list->tail != -1){
+        list->next[list->tail] = page_number;
     }
-/*If the page being referenced is not in memory and there are no free frames for the process, a
-page needs to be replaced. The function selects among all the pages of the process that are
-currently in memory (i.e., they have valid bits as true) the page that has the smallest
-last_access_timestamp. It marks that page-table entry as invalid, along with setting the
-arrival_timestamp, last_access_timestamp and reference_count to 0. It then sets the
-frame_number of the page-table entry of the newly-referenced page to the newly freed frame. It
-also sets the arrival_timestamp, the last_access_timestamp and the reference_count fields of
-the page-table entry appropriately. The function counts this page access as a page fault.
-The function returns the total number of page faults encountered in the simulation.*/
     else {
-        int smallest_reference_count = INT_MAX;
-        int smallest_loc = 0;
-
-        for(int i = 0; i < table_cnt; i++){
-            if(page_table[i].is_valid != 0){ //checks if the page is in memory 
-                 if(page_table[i].reference_count < smallest_reference_count){ //checks if the references are lower than the last page
-                    smallest_reference_count = page_table[i].reference_count;//The lowest reference count is saved for the loop 
-                    smallest_loc = i;//the lowest referenced location is saved
-                 }
-            }
-        }
-        page_table[refrence_string[i]].frame_number = page_table[smallest_loc].frame_number; //replaces the page in memory
-        page_table[refrence_string[i]].is_valid = 1; //sets it to valid so the fact its in memory is marked
-        page_table[refrence_string[i]].arrival_timestamp = timestamp;//updates arrival time
-        page_table[refrence_string[i]].last_access_timestamp = timestamp;//updates  last access time
-        page_table[refrence_string[i]].reference_count = 1;//this is the first time it was referenced the count is 1
-        
-        //Move to the page no longer in memory all values are set to null since it is no longer in memory
-
-        page_table[smallest_loc].frame_number = -1;
-        page_table[smallest_loc].is_valid = 0;
-        page_table[smallest_loc].arrival_timestamp = -1;
-        page_table[smallest_loc].last_access_timestamp = -1;
-        page_table[smallest_loc].reference_count = -1;
-
-        page_fault_counter += 1;
-        
-    }   
-    timestamp += 1; 
-}
-    return page_fault_counter;
+        list->head = page_number;
+    }
+    list->tail = page_number;
+    list->size += 1;
 }
 
-int process_page_access_lru(struct PTE page_table[TABLEMAX],
-int *table_cnt, 
-int page_number, 
-int frame_pool[POOLMAX],
-int *frame_cnt, 
-int current_timestamp)
+void lru_list_unlink(struct LRU_LIST *list, int page_number)
 {
-    /*The function determines the memory frame number for the logical page and returns this
-number.
-
-First the function checks if the page being referenced is already in memory (i.e., the page-table
-entry has the valid bit true). If so, it returns the frame number, after modifying the
-last_access_timestamp and the reference_count fields of the page-table entry.*/
-   if (page_table[page_number].is_valid !=0 ){
-       page_table[page_number].reference_count += 1; //update reference count
-       page_table[page_number].last_access_timestamp = current_timestamp; //update time
-       return page_table[page_number].frame_number;//returns frame number
+    int prev = list->prev[page_number];
+    int next = list->next[page_number];
+
+    if(prev != -1){
+        list->next[prev] = next;
+    }
+    else {
+        list->head = next;
     }
+    if(next != -1){
+        list->prev[next] = prev;
+    }
+    else {
+        list->tail = prev;
+    }
+    list->prev[page_number] = -1;
+    list->next[page_number] = -1;
+    list->size -= 1;
+}
 
-/*If the page being referenced is not in memory, the function checks if there are any free frames
-(i.e., the process frame pool is not empty). If so, a frame is removed from the process frame
-pool and the frame number is inserted into the page-table entry corresponding to the logical
-page number. In addition, the other fields of the page-table entry are set appropriately. The
-function returns the frame number associated with the page-table entry.*/
-    else if(page_table[page_number].is_valid == 0 && *frame_cnt > 0){
+static int list_access(struct LRU_LIST *list,
+struct PTE page_table[],
+int page_number,
+int frame_pool[],
+int *frame_cnt,
+int current_timestamp,
+int move_on_hit)
+{
+    struct PTE *entry = &page_table[page_number];
+    int victim;
+
+    if(entry->is_valid != 0){
+        entry->reference_count += 1; //update reference count
+        entry->reference_bit = 1;
+        entry->last_access_timestamp = current_timestamp; //update time
+        if(move_on_hit){
+            lru_list_unlink(list, page_number);
+            lru_list_push(list, page_number); //now the most recently used page
+        }
+        return entry->frame_number;
+    }
+    if(*frame_cnt > 0){
         *frame_cnt -= 1; //lowers frame count
-        page_table[page_number].frame_number = frame_pool[*frame_cnt];//updates the number of free frames
-        page_table[page_number].reference_count = 1; //update reference count
-        page_table[page_number].last_access_timestamp = current_timestamp; //update last access time
-        page_table[page_number].arrival_timestamp = current_timestamp;//just moved to memory so new arrival time
-        page_table[page_number].is_valid = 1; //moved to memory so it is valid
-        return page_table[page_number].frame_number;
+        entry->frame_number = frame_pool[*frame_cnt];
     }
-/*If the page being referenced is not in memory and there are no free frames for the process, a
-page needs to be replaced. The function selects among all the pages of the process that are
-currently in memory (i.e., they have valid bits as true) the page that has the smallest
-reference_count. If multiple pages have the smallest reference_count, the one with the smallest
-arrival_timestamp among these is selected. After selecting the page for replacement, the
-function marks that page-table entry as invalid, and sets the frame_number, arrival_timestamp,
-last_access_timestamp and reference_count to -1. It then sets the frame_number of the
-page-table entry of the newly-referenced page to the newly freed frame. It also sets the
-arrival_timestamp, the last_access_timestamp and the reference_count fields of the page-table
-entry appropriately. Finally, the function returns this frame number.
-*/
     else {
-        int smallest_access_timestamp = INT_MAX;//potential bug here using location 0 in table
-        int smallest_loc = 0;
+        victim = list->head; //oldest page on the list
+        if(victim == -1){
+            return -1;
+        }
+        lru_list_unlink(list, victim);
+        entry->frame_number = page_table[victim].frame_number; //replaces the page in memory
+
+        page_table[victim].frame_number = -1;
+        page_table[victim].is_valid = 0;
+        page_table[victim].arrival_timestamp = -1;
+        page_table[victim].last_access_timestamp = -1;
+        page_table[victim].reference_count = -1;
+        page_table[victim].reference_bit = 0;
+    }
+    entry->is_valid = 1;
+    entry->arrival_timestamp = current_timestamp;
+    entry->last_access_timestamp = current_timestamp;
+    entry->reference_count = 1;
+    entry->reference_bit = 1;
+    lru_list_push(list, page_number);
+    return entry->frame_number;
+}
 
-        for(int i = 0; i < *table_cnt; i++){
-            if(page_table[i].is_valid != 0) {
-                if(page_table[i].last_access_timestamp < smallest_access_timestamp){
-                    smallest_access_timestamp = page_table[i].last_access_timestamp;
-                    smallest_loc = i;
-                }
+int lru_list_access(struct LRU_LIST *list,
+struct PTE page_table[],
+int page_number,
+int frame_pool[],
+int *frame_cnt,
+int current_timestamp)
+{
+    /*Same contract as process_page_access_lru, but the page to replace is taken from the head of
+the recency list instead of being searched for. The list must have been set up with lru_list_init
+over the same page table and only be changed through this function afterwards.
+Returns -1 if there is neither a free frame nor a page in memory to replace.*/
+    return list_access(list, page_table, page_number, frame_pool, frame_cnt, current_timestamp, 1);
+}
 
-            }
-        }
-        page_table[page_number].frame_number = page_table[smallest_loc].frame_number;
-        page_table[page_number].is_valid = 1;
-        page_table[page_number].arrival_timestamp = current_timestamp;
-        page_table[page_number].last_access_timestamp = current_timestamp;
-        page_table[page_number].reference_count = 1;
-
-        page_table[smallest_loc].frame_number = -1;
-        page_table[smallest_loc].is_valid = 0;
-        page_table[smallest_loc].arrival_timestamp = -1;
-        page_table[smallest_loc].last_access_timestamp = -1;
-        page_table[smallest_loc].reference_count = -1;
-        return page_table[page_number].frame_number;
+int fifo_list_access(struct LRU_LIST *list,
+struct PTE page_table[],
+int page_number,
+int frame_pool[],
+int *frame_cnt,
+int current_timestamp)
+{
+    //same as lru_list_access but a hit leaves the page where it is, so the head is the earliest arrival
+    return list_access(list, page_table, page_number, frame_pool, frame_cnt, current_timestamp, 0);
+}
+
+static int lfu_before(struct PTE page_table[], int a, int b)
+{
+    //smaller reference_count first, then earlier arrival_timestamp, then lower page number
+    int count_a = MAX(page_table[a].reference_count, 1); //a prefetched page ranks as referenced once
+    int count_b = MAX(page_table[b].reference_count, 1);
+
+    if(count_a != count_b){
+        return count_a < count_b;
+    }
+    if(page_table[a].arrival_timestamp != page_table[b].arrival_timestamp){
+        return page_table[a].arrival_timestamp < page_table[b].arrival_timestamp;
     }
+    return a < b;
+}
 
-    
+static void lfu_place(struct LFU_TABLE *lfu, int index, int page_number)
+{
+    lfu->heap[index] = page_number;
+    lfu->position[page_number] = index;
 }
-int count_page_faults_lru(struct PTE page_table[TABLEMAX],
-int table_cnt,
-int refrence_string[REFERENCEMAX],
-int reference_cnt,
-int frame_pool[POOLMAX],
-int frame_cnt)
+
+static void lfu_sift_up(struct LFU_TABLE *lfu, struct PTE page_table[], int index)
 {
-    int page_fault_counter = 0;
-    int timestamp = 1;
-    /*The function returns the estimated number of page faults for the reference string, with respect to
-the pool of frames allocated to the process. For each logical page number (in the sequence),
-the function simulates the processing of the page access in the LFU system. It keeps track of
-the number of page faults that occur in the system as it simulates the processing of the entire
-sequence of logical page numbers.*/
-
-/*When simulating the processing of a page access, the function first checks if the page being
-referenced is already in memory (i.e., the page-table entry has the valid bit true). If so, it
-modifies the last_access_timestamp and the reference_count fields of the page-table entry. It
-then moves on to the processing of the next entry in the sequence of logical page numbers.
-In order to simulate timestamps, the function starts with a timestamp of 1 and increments it
-whenever the processing of a new page access is begun.*/
-    for(int i = 0; i < reference_cnt; i++){ 
-        if (page_table[refrence_string[i]].is_valid !=0 ){
-            page_table[refrence_string[i]].reference_count += 1; //update reference count
-            page_table[refrence_string[i]].last_access_timestamp = timestamp; //update time
-        }
+    int page_number = lfu->heap[index];
 
-/*If the page being referenced is not in memory, the function checks if there are any free frames
-(i.e., the process frame pool is not empty). If so, a frame is removed from the process frame
-pool and the frame number is inserted into the page-table entry corresponding to the logical
-page number. In addition, the other fields of the page-table entry are set appropriately. The
-function counts this page access as a page fault.*/
-        else if(page_table[refrence_string[i]].is_valid == 0 && frame_cnt > 0){
-            frame_cnt -= 1; //lowers frame count
-            page_table[refrence_string[i]].frame_number = frame_pool[frame_cnt];//updates the number of free frames
-            page_table[refrence_string[i]].reference_count = 1; //update reference count
-            page_table[refrence_string[i]].last_access_timestamp = timestamp; //update last access time
-            page_table[refrence_string[i]].arrival_timestamp = timestamp;//just moved to memory so new arrival time
-            page_table[refrence_string[i]].is_valid = 1; //moved to memory so it is valid
-            page_fault_counter += 1;
-            timestamp += 1;
-        }
+    while(index > 0 && lfu_before(page_table, page_number, lfu->heap[(index - 1) / 2])){
+        lfu_place(lfu, index, lfu->heap[(index - 1) / 2]);
+        index = (index - 1) / 2;
+    }
+    lfu_place(lfu, index, page_number);
+}
 
-/*If the page being referenced is not in memory and there are no free frames for the process, a
-page needs to be replaced. The function selects among all the pages of the process that are
-currently in memory (i.e., they have valid bits as true) the page that has the smallest
-reference_count. If multiple pages exist with the smallest reference_count, the one with the
-smallest arrival_timestamp is chosen. The function then marks that page-table entry as invalid,
-along with setting the arrival_timestamp, last_access_timestamp and reference_count to 0. It
-then sets the frame_number of the page-table entry of the newly-referenced page to the newly
-freed frame. It also sets the arrival_timestamp, the last_access_timestamp and the
-reference_count fields of the page-table entry appropriately. The function counts this page
-access as a page fault.
-The function returns the total number of page faults encountered in the simulation*/
-    else {
-        int smallest_access_timestamp = INT_MAX;//potential bug here using location 0 in table
-        int smallest_loc = 0;
+static void lfu_sift_down(struct LFU_TABLE *lfu, struct PTE page_table[], int index)
+{
+    int page_number = lfu->heap[index];
 
-        for(int i = 0; i < table_cnt; i++){
-            if(page_table[i].is_valid != 0) {
-                if(page_table[i].last_access_timestamp < smallest_access_timestamp){
-                    smallest_access_timestamp = page_table[i].last_access_timestamp;
-                    smallest_loc = i;
-                }
+    while(2 * index + 1 < lfu->size){
+        int child = 2 * index + 1;
+
+        if(child + 1 < lfu->size && lfu_before(page_table, lfu->heap[child + 1], lfu->heap[child])){
+            child += 1;
+        }
+        if(!lfu_before(page_table, lfu->heap[child], page_number)){
+            break;
+        }
+        lfu_place(lfu, index, lfu->heap[child]);
+        index = child;
+    }
+    lfu_place(lfu, index, page_number);
+}
 
-            }
+int lfu_table_init(struct LFU_TABLE *lfu,
+int heap[],
+int position[],
+struct PTE page_table[],
+int table_cnt)
+{
+    /*Builds the heap from every page that is already in memory. The heap and position arrays are owned
+by the caller and must hold table_cnt entries each. Always returns 0.*/
+    lfu->heap = heap;
+    lfu->position = position;
+    lfu->size = 0;
+    for(int i = 0; i < table_cnt; i++){
+        position[i] = -1;
+        if(page_table[i].is_valid != 0){
+            lfu_place(lfu, lfu->size++, i);
         }
-        page_table[refrence_string[i]].frame_number = page_table[smallest_loc].frame_number;
-        page_table[refrence_string[i]].is_valid = 1;
-        page_table[refrence_string[i]].arrival_timestamp = timestamp;
-        page_table[refrence_string[i]].last_access_timestamp = timestamp;
-        page_table[refrence_string[i]].reference_count = 1;
-
-        page_table[smallest_loc].frame_number = -1;
-        page_table[smallest_loc].is_valid = 0;
-        page_table[smallest_loc].arrival_timestamp = -1;
-        page_table[smallest_loc].last_access_timestamp = -1;
-        page_table[smallest_loc].reference_count = -1;
-
-        page_fault_counter += 1;
-        timestamp += 1;
     }
+    for(int i = lfu->size / 2 - 1; i >= 0; i--){
+        lfu_sift_down(lfu, page_table, i);
     }
-    return page_fault_counter;
-    //fin
-}
\ No newline at end of file
+    return 0;
+}
+
+int lfu_table_access(struct LFU_TABLE *lfu,
+struct PTE page_table[],
+int page_number,
+int frame_pool[],
+int *frame_cnt,
+int current_timestamp)
+{
+    /*Same contract as process_page_access_lfu, but the page to replace is the top of a min-heap on
+(reference_count, arrival_timestamp, page number), the order the scan picks it in. A hit only raises
+the page's count, so it sifts down. Every access is O(log n) in the number of pages in memory.
+Returns -1 if there is neither a free frame nor a page in memory to replace.*/
+    struct PTE *entry = &page_table[page_number];
+    int victim;
+
+    if(entry->is_valid != 0){
+        entry->reference_count += 1; //update reference count
+        entry->reference_bit = 1;
+        entry->last_access_timestamp = current_timestamp; //update time
+        lfu_sift_down(lfu, page_table, lfu->position[page_number]);
+        return entry->frame_number;
+    }
+    if(*frame_cnt > 0){
+        *frame_cnt -= 1; //lowers frame count
+        entry->frame_number = frame_pool[*frame_cnt];
+    }
+    else {
+        if(lfu->size == 0){
+            return -1;
+        }
+        victim = lfu->heap[0]; //least frequently used, earliest arrival
+        lfu->position[victim] = -1;
+        lfu->size -= 1;
+        if(lfu->size > 0){
+            lfu_place(lfu, 0, lfu->heap[lfu->size]);
+            lfu_sift_down(lfu, page_table, 0);
+        }
+        entry->frame_number = page_table[victim].frame_number; //replaces the page in memory
+
+        page_table[victim].frame_number = -1;
+        page_table[victim].is_valid = 0;
+        page_table[victim].arrival_timestamp = -1;
+        page_table[victim].last_access_timestamp = -1;
+        page_table[victim].reference_count = -1;
+        page_table[victim].reference_bit = 0;
+    }
+    entry->is_valid = 1;
+    entry->arrival_timestamp = current_timestamp;
+    entry->last_access_timestamp = current_timestamp;
+    entry->reference_count = 1;
+    entry->reference_bit = 1;
+    lfu_place(lfu, lfu->size++, page_number);
+    lfu_sift_up(lfu, page_table, lfu->size - 1);
+    return entry->frame_number;
+}
@@ -0,0 +1,186 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "oslabs.h"
+
+/*Dynamic frame allocation: instead of a fixed frame_cnt, the process's resident set grows and shrinks
+with its locality, drawing frames from the pool and handing them back.
+
+Under the working-set policy the resident set is exactly the pages referenced in the last window
+references. Those are the tail of the LRU list, so after each reference the pages at the head that
+have fallen out of the window leave memory. Under page-fault frequency the resident set only changes on
+a fault. If the fault comes sooner than 1 / upper_rate references after the last one, the process is
+short of frames and the page gets a new one. If it comes later than 1 / lower_rate references after,
+the pages not referenced since the last fault leave memory first. In between the page replaces the
+least recently used one, so the size holds.
+
+Both fall back to replacing the least recently used page when the pool runs dry.*/
+
+static void release_page(struct LRU_LIST *list, struct PTE page_table[], int page_number, int frame_pool[], int *frame_cnt)
+{
+    //takes the page out of memory and gives its frame back to the pool
+    struct PTE *entry = &page_table[page_number];
+
+    lru_list_unlink(list, page_number);
+    frame_pool[(*frame_cnt)++] = entry->frame_number;
+    entry->frame_number = -1;
+    entry->is_valid = 0;
+    entry->arrival_timestamp = -1;
+    entry->last_access_timestamp = -1;
+    entry->reference_count = -1;
+    entry->reference_bit = 0;
+}
+
+static int count_page_faults_dynamic(int pff,
+struct PTE page_table[],
+int table_cnt,
+int reference_string[],
+int reference_cnt,
+int frame_pool[],
+int frame_cnt,
+int window,
+double lower_rate,
+double upper_rate,
+int phase_length,
+long long phase_faults[],
+struct RESIDENT_STATS *stats)
+{
+    struct RESIDENT_STATS totals;
+    struct ARENA arena;
+    struct LRU_LIST list;
+    int *prev;
+    int *next;
+    int last_fault = 0;
+    int page_fault_counter = 0;
+
+    if(stats == NULL){
+        stats = &totals; //the caller only wants the faults
+    }
+    stats->references = 0;
+    stats->page_faults = 0;
+    stats->replacements = 0;
+    stats->releases = 0;
+    stats->resident_sum = 0;
+    stats->max_resident = 0;
+    stats->phase_cnt = reference_cnt > 0 ? (reference_cnt - 1) / phase_length + 1 : 0;
+    arena.base = malloc(2 * arena_size((size_t)table_cnt * sizeof(int)));
+    arena.used = 0;
+    if(arena.base == NULL){
+        return -1;
+    }
+    prev = arena_take(&arena, (size_t)table_cnt * sizeof(int));
+    next = arena_take(&arena, (size_t)table_cnt * sizeof(int));
+    if(lru_list_init(&list, prev, next, page_table, table_cnt) != 0){
+        free(arena.base);
+        return -1;
+    }
+    for(int i = 0; phase_faults != NULL && i < stats->phase_cnt; i++){
+        phase_faults[i] = 0;
+    }
+    for(int i = 0; i < reference_cnt; i++){
+        int page_number = reference_string[i];
+        int timestamp = i + 1;
+        int resident;
+
+        if(page_number < 0 || page_number >= table_cnt){
+            free(arena.base);
+            return -1;
+        }
+        resident = list.size;
+        if(page_table[page_number].is_valid != 0){
+            lru_list_access(&list, page_table, page_number, frame_pool, &frame_cnt, timestamp);
+        }
+        else {
+            int no_frames = 0;
+            int *free_cnt = &frame_cnt;
+
+            if(pff){
+                double rate = 1.0 / (timestamp - last_fault);
+
+                if(rate < lower_rate){
+                    while(list.head != -1 && page_table[list.head].last_access_timestamp < last_fault){
+                        release_page(&list, page_table, list.head, frame_pool, &frame_cnt);
+                        stats->releases += 1;
+                    }
+                    resident = list.size;
+                }
+                else if(rate <= upper_rate && list.size > 0){
+                    free_cnt = &no_frames; //the size holds, so the page replaces one
+                }
+                last_fault = timestamp;
+            }
+            if(lru_list_access(&list, page_table, page_number, frame_pool, free_cnt, timestamp) == -1){
+                free(arena.base);
+                return -1; //no frame in the pool and nothing to replace
+            }
+            if(list.size == resident){
+                stats->replacements += 1;
+            }
+            page_fault_counter += 1;
+            if(phase_faults != NULL){
+                phase_faults[i / phase_length] += 1;
+            }
+        }
+        while(!pff && list.head != -1 && page_table[list.head].last_access_timestamp <= timestamp - window){
+            release_page(&list, page_table, list.head, frame_pool, &frame_cnt); //out of the window
+            stats->releases += 1;
+        }
+        stats->resident_sum += list.size;
+        stats->max_resident = MAX(stats->max_resident, list.size);
+    }
+    stats->references = reference_cnt;
+    stats->page_faults = page_fault_counter;
+    free(arena.base);
+    return page_fault_counter;
+}
+
+int count_page_faults_ws(struct PTE page_table[],
+int table_cnt,
+int reference_string[],
+int reference_cnt,
+int frame_pool[],
+int frame_cnt,
+int window,
+int phase_length,
+long long phase_faults[],
+struct RESIDENT_STATS *stats)
+{
+    /*Returns the number of page faults for the reference string when the process keeps its working set
+of the last window references in memory, starting with a timestamp of 1 and incrementing it for every
+page access. frame_cnt is the number of free frames at the top of frame_pool, which must have room for
+the frames of the pages already in memory too, since released frames go back to it. When the pool is
+empty a fault replaces the least recently used page.
+
+If phase_faults is not NULL it receives the faults in each phase of phase_length references, and if
+stats is not NULL it receives the totals and the resident set size summed over every reference. Returns -1 if an argument is
+invalid, the link arrays cannot be allocated or the reference string names a page outside the page
+table.*/
+    if(table_cnt <= 0 || frame_cnt < 0 || window <= 0 || phase_length <= 0){
+        return -1;
+    }
+    return count_page_faults_dynamic(0, page_table, table_cnt, reference_string, reference_cnt, frame_pool, frame_cnt, window, 0.0,
+        0.0, phase_length, phase_faults, stats);
+}
+
+int count_page_faults_pff(struct PTE page_table[],
+int table_cnt,
+int reference_string[],
+int reference_cnt,
+int frame_pool[],
+int frame_cnt,
+double lower_rate,
+double upper_rate,
+int phase_length,
+long long phase_faults[],
+struct RESIDENT_STATS *stats)
+{
+    /*Same as count_page_faults_ws, but the resident set is steered by the page-fault frequency, in
+faults per reference, measured from one fault to the next. Above upper_rate the faulting page gets a
+new frame, below lower_rate the pages not referenced since the previous fault are released first, and
+in between it replaces the least recently used page. Returns -1 if lower_rate is negative or larger
+than upper_rate, and in the cases count_page_faults_ws does.*/
+    if(table_cnt <= 0 || frame_cnt < 0 || lower_rate < 0.0 || upper_rate < lower_rate || phase_length <= 0){
+        return -1;
+    }
+    return count_page_faults_dynamic(1, page_table, table_cnt, reference_string, reference_cnt, frame_pool, frame_cnt, 0, lower_rate,
+        upper_rate, phase_length, phase_faults, stats);
+}